@@ -0,0 +1,441 @@
+// Microbenchmarks of HashTable and the priority queues against the
+// standard containers.
+//
+//   g++ -std=c++17 -O2 -DNDEBUG bench_containers.cpp -o bench_containers
+//   ./bench_containers [--max-size N] [--ops N] [--budget-ms N] [--filter TEXT]
+//
+// Every result is printed as one JSON object per line:
+//   container, op, dist, n (elements in the container), ops (timed
+//   operations), ns_per_op (mean), p50_ns/p90_ns/p99_ns, peak_rss_kb.
+//
+// Operations are timed in batches of BATCH_SIZE; the percentiles are
+// over the per-operation average of each batch, since timing a single
+// operation costs about as much as the operation itself. peak_rss_kb
+// is the process peak so far, so run one container at a time with
+// --filter when comparing memory use. --filter matches against
+// "<container> <dist>", e.g. --filter "HashTable zipfian".
+//
+// The --ops phases (lookups, churn, decreaseKey, hold) stop early once
+// they have run for --budget-ms, so a pathological case shows up as a
+// high ns_per_op with a small ops count instead of stalling the run.
+// The phases that build or drain the container always run to the end.
+//
+// PriorityQueue save and load go through an in-memory stream and are
+// timed as a single operation over the whole queue, so ns_per_op is
+// the time for all n elements; --filter PriorityQueue --max-size 10000000
+// times a 10M-element checkpoint.
+//
+// Sizes go from 1K elements (fits in L1) by factors of 16 up to
+// --max-size (default 4M, well beyond the last level cache). Key
+// distributions:
+//   sequential  keys 0..n-1, accessed in order
+//   uniform     scattered distinct keys below 2^28, accessed uniformly
+//               at random
+//   zipfian     same keys, accessed with a Zipf(0.99) skew
+//   strided     keys 0, 64, 128, ..., accessed in order
+
+#include "hash_table.hpp"
+#include "priority_queue.hpp"
+#include "pairing_heap.hpp"
+#include "radix_heap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/resource.h>
+
+const unsigned BATCH_SIZE = 64;
+const unsigned STRIDE = 64;
+const unsigned SCATTER = 2654435761u;   // odd, so a bijection modulo 2^28
+const unsigned SCATTER_MASK = (1u << 28) - 1;
+
+struct Result{
+    unsigned ops;
+    double ns_per_op;
+    double p50_ns;
+    double p90_ns;
+    double p99_ns;
+};
+
+unsigned long long checksum = 0;   // keeps the timed work observable
+std::string filter;
+double budget_ns = 1e9;
+
+long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * Runs @op(0) .. @op(num_ops-1). If @bounded, stops after the first
+ * batch that takes the total past budget_ns.
+ */
+template <typename Op>
+Result measure(unsigned num_ops, bool bounded, Op op) {
+    std::vector<double> batches;
+    double total_ns = 0;
+    unsigned done = 0;
+
+    while(done < num_ops && !(bounded && total_ns > budget_ns)) {
+        unsigned end = std::min(done + BATCH_SIZE, num_ops);
+        auto start = std::chrono::steady_clock::now();
+        for(unsigned i = done; i < end; i++) {
+            checksum += op(i);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        total_ns += ns;
+        batches.push_back(ns / (end - done));
+        done = end;
+    }
+    if(batches.empty()) {
+        return {0, 0, 0, 0, 0};
+    }
+
+    std::sort(batches.begin(), batches.end());
+    auto percentile = [&batches](double p) {
+        return batches[std::min<std::size_t>(batches.size() - 1, (std::size_t)(p * batches.size()))];
+    };
+    return {done, total_ns / done, percentile(0.5), percentile(0.9), percentile(0.99)};
+}
+
+bool selected(const std::string& container, const std::string& dist) {
+    return filter.empty() || (container + " " + dist).find(filter) != std::string::npos;
+}
+
+void report(const std::string& container, const std::string& op, const std::string& dist,
+            unsigned n, const Result& result) {
+    std::cout << "{\"container\":\"" << container << "\",\"op\":\"" << op
+              << "\",\"dist\":\"" << dist << "\",\"n\":" << n << ",\"ops\":" << result.ops
+              << ",\"ns_per_op\":" << result.ns_per_op << ",\"p50_ns\":" << result.p50_ns
+              << ",\"p90_ns\":" << result.p90_ns << ",\"p99_ns\":" << result.p99_ns
+              << ",\"peak_rss_kb\":" << peakRssKb() << "}" << std::endl;
+}
+
+/**
+ * Keys and access pattern for one distribution: @keys are the n
+ * distinct keys to insert, @hits indexes into @keys for each lookup,
+ * @misses are keys that are never inserted.
+ */
+struct Workload{
+    std::string dist;
+    std::vector<unsigned> keys;
+    std::vector<unsigned> hits;
+    std::vector<unsigned> misses;
+};
+
+Workload makeWorkload(const std::string& dist, unsigned n, unsigned num_ops, std::mt19937& rng) {
+    Workload w;
+    w.dist = dist;
+    w.keys.resize(n);
+    w.hits.resize(num_ops);
+    w.misses.resize(num_ops);
+
+    for(unsigned i = 0; i < n; i++) {
+        if(dist == "sequential") {
+            w.keys[i] = i;
+        }else if(dist == "strided") {
+            w.keys[i] = i * STRIDE;
+        }else {
+            w.keys[i] = (i * SCATTER) & SCATTER_MASK;
+        }
+    }
+    for(unsigned i = 0; i < num_ops; i++) {
+        if(dist == "sequential") {
+            w.misses[i] = n + i;
+        }else if(dist == "strided") {
+            w.misses[i] = (i % n) * STRIDE + 1;
+        }else {
+            w.misses[i] = ((n + i) * SCATTER) & SCATTER_MASK;
+        }
+    }
+
+    if(dist == "uniform") {
+        std::uniform_int_distribution<unsigned> pick(0, n - 1);
+        for(unsigned i = 0; i < num_ops; i++) {
+            w.hits[i] = pick(rng);
+        }
+    }else if(dist == "zipfian") {
+        std::vector<double> cdf(n);
+        double sum = 0;
+        for(unsigned i = 0; i < n; i++) {
+            sum += 1.0 / std::pow(i + 1.0, 0.99);
+            cdf[i] = sum;
+        }
+        // rank r is a random key, not key r, so the hot keys are scattered
+        std::vector<unsigned> rank_to_index(n);
+        for(unsigned i = 0; i < n; i++) {
+            rank_to_index[i] = i;
+        }
+        std::shuffle(rank_to_index.begin(), rank_to_index.end(), rng);
+        std::uniform_real_distribution<double> pick(0, sum);
+        for(unsigned i = 0; i < num_ops; i++) {
+            unsigned rank = std::lower_bound(cdf.begin(), cdf.end(), pick(rng)) - cdf.begin();
+            w.hits[i] = rank_to_index[std::min(rank, n - 1)];
+        }
+    }else {
+        for(unsigned i = 0; i < num_ops; i++) {
+            w.hits[i] = i % n;
+        }
+    }
+    return w;
+}
+
+void benchHashTable(const Workload& w, unsigned num_ops) {
+    unsigned n = w.keys.size();
+
+    if(selected("HashTable", w.dist)) {
+        HashTable<unsigned> ht(nextPrime(2 * n + 1));
+        report("HashTable", "insert", w.dist, n, measure(n, false, [&](unsigned i) {
+            return (unsigned)ht.insert(w.keys[i], i);
+        }));
+        report("HashTable", "get-hit", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+            return *ht.get(w.keys[w.hits[i]]);
+        }));
+        report("HashTable", "get-miss", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+            return (unsigned)(ht.get(w.misses[i]) != nullptr);
+        }));
+        // remove a key and insert a fresh one, keeping the size at n
+        report("HashTable", "churn", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+            unsigned slot = w.hits[i];
+            unsigned removed = ht.remove(w.keys[slot]);
+            return removed + ht.insert(w.keys[slot], i);
+        }));
+        report("HashTable", "remove", w.dist, n, measure(n, false, [&](unsigned i) {
+            return (unsigned)ht.remove(w.keys[i]);
+        }));
+    }
+
+    if(selected("std::unordered_map", w.dist)) {
+        std::unordered_map<unsigned, unsigned> map;
+        report("std::unordered_map", "insert", w.dist, n, measure(n, false, [&](unsigned i) {
+            return (unsigned)map.emplace(w.keys[i], i).second;
+        }));
+        report("std::unordered_map", "get-hit", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+            return map.find(w.keys[w.hits[i]])->second;
+        }));
+        report("std::unordered_map", "get-miss", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+            return (unsigned)(map.find(w.misses[i]) != map.end());
+        }));
+        report("std::unordered_map", "churn", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+            unsigned slot = w.hits[i];
+            unsigned removed = map.erase(w.keys[slot]);
+            return removed + (unsigned)map.emplace(w.keys[slot], i).second;
+        }));
+        report("std::unordered_map", "remove", w.dist, n, measure(n, false, [&](unsigned i) {
+            return (unsigned)map.erase(w.keys[i]);
+        }));
+    }
+}
+
+/**
+ * insert, decreaseKey, remove and deleteMin on an engine with the
+ * PriorityQueue API. Keys are spaced 8 apart so that most decreaseKey
+ * calls do not collide with another key.
+ */
+template <typename Queue>
+void benchKeyedQueue(const std::string& name, Queue& pq, const Workload& w, unsigned num_ops, std::mt19937& rng) {
+    unsigned n = w.keys.size();
+    std::vector<unsigned> keys(n);
+    for(unsigned i = 0; i < n; i++) {
+        keys[i] = w.keys[i] * 8 + 1024;
+    }
+
+    report(name, "insert", w.dist, n, measure(n, false, [&](unsigned i) {
+        return (unsigned)pq.insert(keys[i], i);
+    }));
+
+    std::vector<unsigned> changes(num_ops);
+    for(unsigned i = 0; i < num_ops; i++) {
+        changes[i] = rng() % 7 + 1;
+    }
+    report(name, "decreaseKey", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+        unsigned slot = w.hits[i];
+        if(keys[slot] <= changes[i] || !pq.decreaseKey(keys[slot], changes[i])) {
+            return 0u;
+        }
+        keys[slot] -= changes[i];
+        return 1u;
+    }));
+
+    unsigned num_removed = n / 2;
+    report(name, "remove", w.dist, n, measure(num_removed, false, [&](unsigned i) {
+        return (unsigned)pq.remove(keys[w.keys.size() - 1 - i]);
+    }));
+
+    unsigned left = pq.numElements();
+    report(name, "deleteMin", w.dist, n, measure(left, false, [&](unsigned) {
+        return (unsigned)pq.deleteMin();
+    }));
+}
+
+/**
+ * Hold model: the queue stays at n elements while each operation
+ * removes the minimum and inserts an element a random time after
+ * it, as in an event simulation.
+ *
+ * Each of the n elements owns a slot number, packed into the low
+ * slot_bits of its key below its time, so keys are unique without
+ * any retrying and every engine (std::priority_queue included) runs
+ * the same sequence. The times never go below the last minimum, so
+ * the radix heap can run it too. The gaps are scaled to the time
+ * bits left over so that --ops operations fit; a time that would
+ * still overflow is clamped to the largest one, which keeps both
+ * uniqueness and monotonicity.
+ */
+struct HoldWorkload{
+    unsigned slot_bits;
+    unsigned long long time_limit;
+    std::vector<unsigned> initial;   // keys
+    std::vector<unsigned> gaps;      // times
+};
+
+HoldWorkload makeHoldWorkload(const Workload& w, unsigned num_ops, std::mt19937& rng) {
+    unsigned n = w.keys.size();
+    HoldWorkload hold;
+    hold.slot_bits = 0;
+    while((1ull << hold.slot_bits) < n) {
+        ++hold.slot_bits;
+    }
+    hold.time_limit = 1ull << (32 - hold.slot_bits);
+    // the minimum advances by about max_gap / n per operation
+    unsigned max_gap = std::max(1.0, hold.time_limit / (4 * ((double)num_ops / n + 2)));
+
+    hold.initial.resize(n);
+    for(unsigned slot = 0; slot < n; slot++) {
+        hold.initial[slot] = (w.keys[slot] % max_gap) << hold.slot_bits | slot;
+    }
+    hold.gaps.resize(num_ops);
+    for(unsigned i = 0; i < num_ops; i++) {
+        hold.gaps[i] = rng() % max_gap + 1;
+    }
+    return hold;
+}
+
+unsigned nextHoldKey(const HoldWorkload& hold, unsigned min, unsigned i) {
+    unsigned slot = min & ((1ull << hold.slot_bits) - 1);
+    unsigned long long time = (min >> hold.slot_bits) + hold.gaps[i];
+    time = std::min(time, hold.time_limit - 1);
+    return (unsigned)(time << hold.slot_bits) | slot;
+}
+
+template <typename Queue>
+void benchHold(const std::string& name, Queue& pq, const Workload& w, const HoldWorkload& hold, unsigned num_ops) {
+    for(unsigned slot = 0; slot < hold.initial.size(); slot++) {
+        pq.insert(hold.initial[slot], slot);
+    }
+    report(name, "hold", w.dist, hold.initial.size(), measure(num_ops, true, [&](unsigned i) {
+        unsigned min = *pq.getMinKey();
+        pq.deleteMin();
+        pq.insert(nextHoldKey(hold, min, i), min);
+        return min;
+    }));
+}
+
+/**
+ * save() of @pq and load() of the result, each timed as one
+ * operation.
+ */
+void benchCheckpoint(const std::string& name, const PriorityQueue<unsigned>& pq, const std::string& dist) {
+    std::stringstream checkpoint;
+    report(name, "save", dist, pq.numElements(), measure(1, false, [&](unsigned) {
+        pq.save(checkpoint);
+        return (unsigned)checkpoint.tellp();
+    }));
+    report(name, "load", dist, pq.numElements(), measure(1, false, [&](unsigned) {
+        return PriorityQueue<unsigned>::load(checkpoint).numElements();
+    }));
+}
+
+void benchPriorityQueues(const Workload& w, unsigned num_ops, std::mt19937& rng) {
+    unsigned n = w.keys.size();
+    HoldWorkload hold_workload = makeHoldWorkload(w, num_ops, rng);
+
+    if(selected("PriorityQueue", w.dist)) {
+        PriorityQueue<unsigned> pq(n);
+        benchKeyedQueue("PriorityQueue", pq, w, num_ops, rng);
+        PriorityQueue<unsigned> hold(n + 1);
+        benchHold("PriorityQueue", hold, w, hold_workload, num_ops);
+        benchCheckpoint("PriorityQueue", hold, w.dist);
+    }
+    if(selected("PairingHeap", w.dist)) {
+        PairingHeap<unsigned> ph(2 * n);
+        benchKeyedQueue("PairingHeap", ph, w, num_ops, rng);
+        PairingHeap<unsigned> hold(2 * n);
+        benchHold("PairingHeap", hold, w, hold_workload, num_ops);
+    }
+    if(selected("RadixHeap", w.dist)) {
+        RadixHeap<unsigned> hold(n + 1);
+        benchHold("RadixHeap", hold, w, hold_workload, num_ops);
+    }
+
+    if(selected("std::priority_queue", w.dist)) {
+        typedef std::pair<unsigned, unsigned> Item;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+        report("std::priority_queue", "insert", w.dist, n, measure(n, false, [&](unsigned i) {
+            pq.push({w.keys[i] * 8 + 1024, i});
+            return 1u;
+        }));
+        report("std::priority_queue", "deleteMin", w.dist, n, measure(n, false, [&](unsigned) {
+            unsigned min = pq.top().first;
+            pq.pop();
+            return min;
+        }));
+
+        for(unsigned slot = 0; slot < n; slot++) {
+            pq.push({hold_workload.initial[slot], slot});
+        }
+        report("std::priority_queue", "hold", w.dist, n, measure(num_ops, true, [&](unsigned i) {
+            unsigned min = pq.top().first;
+            pq.pop();
+            pq.push({nextHoldKey(hold_workload, min, i), min});
+            return min;
+        }));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned max_size = 1u << 22;
+    unsigned num_ops = 1u << 20;
+
+    for(int i = 1; i < argc; i++) {
+        if(std::strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            max_size = std::stoul(argv[++i]);
+        }else if(std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            num_ops = std::stoul(argv[++i]);
+        }else if(std::strcmp(argv[i], "--budget-ms") == 0 && i + 1 < argc) {
+            budget_ns = std::stod(argv[++i]) * 1e6;
+        }else if(std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        }else {
+            std::cerr << "usage: " << argv[0] << " [--max-size N] [--ops N] [--budget-ms N] [--filter TEXT]\n";
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(12345);
+    const char* dists[] = {"sequential", "uniform", "zipfian", "strided"};
+    std::vector<unsigned> sizes;
+    for(unsigned n = 1u << 10; n < max_size; n *= 16) {
+        sizes.push_back(n);
+    }
+    sizes.push_back(max_size);
+
+    for(unsigned n : sizes) {
+        for(const char* dist : dists) {
+            Workload w = makeWorkload(dist, n, num_ops, rng);
+            benchHashTable(w, num_ops);
+            benchPriorityQueues(w, num_ops, rng);
+        }
+    }
+    std::cerr << "checksum " << checksum << '\n';
+}
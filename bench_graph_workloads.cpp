@@ -0,0 +1,1043 @@
+// End-to-end workloads for PriorityQueue: Dijkstra, Prim and A* on
+// generated graphs, and a discrete-event simulation.
+//
+//   g++ -std=c++17 -O2 -DNDEBUG bench_graph_workloads.cpp -o bench_graph_workloads
+//   ./bench_graph_workloads [--vertices N] [--degree D] [--queries K]
+//                           [--jobs N] [--servers C] [--seed S]
+//                           [--filter TEXT] [--no-verify]
+//
+// Graphs are generated in memory from --seed, so runs are offline and
+// repeatable:
+//   grid      sqrt(N) x sqrt(N) lattice, 4 neighbours
+//   random    N vertices, N*D/2 uniformly random edges plus a random
+//             path through all vertices so that the graph is connected
+//   powerlaw  preferential attachment, D/2 edges per new vertex
+// Every vertex has plane coordinates and every edge weighs at least
+// the distance between its ends, so the straight-line distance is a
+// consistent A* heuristic on all three. --vertices 4M --degree 8 gives
+// 16M undirected (32M directed) edges.
+//
+// dijkstra-packed and prim-packed run the same algorithms on the
+// default PriorityQueue<unsigned>, with the distance packed above the
+// vertex in an unsigned key, and decreaseKey() and getMinValue() +
+// deleteMin() in place of changeKey() and extractMin(). Only 32 bits
+// minus the vertex bits are left for the distance, so they run on a
+// grid of at most 64K vertices, where distances stay below 2^16.
+//
+// The simulation is a pool of --servers servers fed by --jobs
+// arrivals. Waiting jobs abandon the line after a random patience
+// (remove() when they are served first) and the servers change speed
+// periodically (changeKey() on every departure in progress).
+//
+// Every run prints one JSON object per line: the workload and graph,
+// its size (n, m: vertices and edges, or servers and jobs), the time
+// per phase (generate_ms, run_ms and within run_ms the time spent in
+// each queue operation, verify_ms), the number of queue operations,
+// peak_rss_kb, the result and whether it matched the reference. The
+// references use std::priority_queue with lazy deletion, or an ordered
+// std::map for the simulation, and the driver exits with 1 if any of
+// them disagrees, so it can gate changes to priority_queue.inl. Queue
+// operations are timed one by one, which adds about one clock read per
+// operation to run_ms.
+
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+const unsigned INF = std::numeric_limits<unsigned>::max();
+const unsigned GRID_SPACING = 10;
+const unsigned COORDINATE_RANGE = 1u << 16;
+const unsigned PACKED_MAX_VERTICES = 1u << 16;
+
+typedef std::chrono::steady_clock Clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * Queue key of a vertex. PriorityQueue keys must be unique, and a
+ * vertex is in the queue at most once, so the vertex breaks ties
+ * between equal distances.
+ */
+struct DistKey{
+    unsigned dist;
+    unsigned vertex;
+
+    bool operator==(const DistKey& rhs) const {
+        return dist == rhs.dist && vertex == rhs.vertex;
+    }
+    bool operator<(const DistKey& rhs) const {
+        return dist != rhs.dist ? dist < rhs.dist : vertex < rhs.vertex;
+    }
+};
+
+template <>
+struct KeyHash<DistKey>{
+    std::size_t operator()(const DistKey& key) const {
+        return key.vertex * 2654435761u;   // the vertex alone is unique
+    }
+};
+
+/**
+ * Queue key of a simulation event: its time, with the event id
+ * breaking ties in scheduling order.
+ */
+struct SimKey{
+    unsigned long long time;
+    unsigned id;
+
+    bool operator==(const SimKey& rhs) const {
+        return time == rhs.time && id == rhs.id;
+    }
+    bool operator<(const SimKey& rhs) const {
+        return time != rhs.time ? time < rhs.time : id < rhs.id;
+    }
+};
+
+template <>
+struct KeyHash<SimKey>{
+    std::size_t operator()(const SimKey& key) const {
+        return key.id * 2654435761u;
+    }
+};
+
+struct QueueStats{
+    unsigned long long inserts = 0;
+    unsigned long long extract_mins = 0;
+    unsigned long long change_keys = 0;
+    unsigned long long removes = 0;
+    double insert_ms = 0;
+    double extract_ms = 0;
+    double change_ms = 0;
+    double remove_ms = 0;
+};
+
+/**
+ * PriorityQueue that counts and times its operations. Failed
+ * operations throw, since none of the workloads expects one.
+ */
+template <typename ValueType, typename KeyType>
+class CountedQueue
+{
+public:
+    explicit CountedQueue(unsigned maxSize) : pq(maxSize) {}
+
+    bool empty() const {
+        return pq.numElements() == 0;
+    }
+
+    void insert(const KeyType& key, const ValueType& value) {
+        auto start = Clock::now();
+        bool ok = pq.insert(key, value);
+        stats.insert_ms += msSince(start);
+        ++stats.inserts;
+        if(!ok) {
+            throw std::runtime_error("PriorityQueue::insert failed");
+        }
+    }
+
+    KeyValuePair<ValueType, KeyType> extractMin() {
+        auto start = Clock::now();
+        std::optional<KeyValuePair<ValueType, KeyType>> min = pq.extractMin();
+        stats.extract_ms += msSince(start);
+        ++stats.extract_mins;
+        if(!min) {
+            throw std::runtime_error("PriorityQueue::extractMin failed");
+        }
+        return std::move(*min);
+    }
+
+    void changeKey(const KeyType& key, const KeyType& newKey) {
+        auto start = Clock::now();
+        bool ok = pq.changeKey(key, newKey);
+        stats.change_ms += msSince(start);
+        ++stats.change_keys;
+        if(!ok) {
+            throw std::runtime_error("PriorityQueue::changeKey failed");
+        }
+    }
+
+    void remove(const KeyType& key) {
+        auto start = Clock::now();
+        bool ok = pq.remove(key);
+        stats.remove_ms += msSince(start);
+        ++stats.removes;
+        if(!ok) {
+            throw std::runtime_error("PriorityQueue::remove failed");
+        }
+    }
+
+    QueueStats stats;
+
+private:
+    PriorityQueue<ValueType, KeyType> pq;
+};
+
+/**
+ * Reference for the simulation: the same interface on an ordered
+ * std::map.
+ */
+template <typename ValueType, typename KeyType>
+class MapQueue
+{
+public:
+    explicit MapQueue(unsigned) {}
+
+    bool empty() const {
+        return events.empty();
+    }
+    void insert(const KeyType& key, const ValueType& value) {
+        ++stats.inserts;
+        events.emplace(key, value);
+    }
+    KeyValuePair<ValueType, KeyType> extractMin() {
+        ++stats.extract_mins;
+        KeyValuePair<ValueType, KeyType> min;
+        min.key = events.begin()->first;
+        min.value = events.begin()->second;
+        events.erase(events.begin());
+        return min;
+    }
+    void changeKey(const KeyType& key, const KeyType& newKey) {
+        ++stats.change_keys;
+        auto node = events.extract(key);
+        node.key() = newKey;
+        events.insert(std::move(node));
+    }
+    void remove(const KeyType& key) {
+        ++stats.removes;
+        events.erase(key);
+    }
+
+    QueueStats stats;
+
+private:
+    std::map<KeyType, ValueType> events;
+};
+
+/**
+ * CountedQueue over the default PriorityQueue<ValueType> with unsigned
+ * keys, going through decreaseKey() and getMinValue() + deleteMin().
+ * decreaseKey() is counted and timed as a key change.
+ */
+template <typename ValueType>
+class PackedQueue
+{
+public:
+    explicit PackedQueue(unsigned maxSize) : pq(maxSize) {}
+
+    bool empty() const {
+        return pq.numElements() == 0;
+    }
+
+    void insert(unsigned key, const ValueType& value) {
+        auto start = Clock::now();
+        bool ok = pq.insert(key, value);
+        stats.insert_ms += msSince(start);
+        ++stats.inserts;
+        if(!ok) {
+            throw std::runtime_error("PriorityQueue::insert failed");
+        }
+    }
+
+    ValueType extractMin() {
+        auto start = Clock::now();
+        const ValueType* min = pq.getMinValue();
+        if(min == nullptr) {
+            throw std::runtime_error("PriorityQueue::getMinValue failed");
+        }
+        ValueType value = *min;
+        bool ok = pq.deleteMin();
+        stats.extract_ms += msSince(start);
+        ++stats.extract_mins;
+        if(!ok) {
+            throw std::runtime_error("PriorityQueue::deleteMin failed");
+        }
+        return value;
+    }
+
+    void decreaseKey(unsigned key, unsigned change) {
+        auto start = Clock::now();
+        bool ok = pq.decreaseKey(key, change);
+        stats.change_ms += msSince(start);
+        ++stats.change_keys;
+        if(!ok) {
+            throw std::runtime_error("PriorityQueue::decreaseKey failed");
+        }
+    }
+
+    QueueStats stats;
+
+private:
+    PriorityQueue<ValueType> pq;
+};
+
+/**
+ * Undirected graph in compressed sparse row form: the edges of vertex
+ * u are targets/weights[offsets[u] .. offsets[u+1]), each undirected
+ * edge stored once in each direction.
+ */
+struct Graph{
+    unsigned num_vertices = 0;
+    std::vector<unsigned> offsets;
+    std::vector<unsigned> targets;
+    std::vector<unsigned> weights;
+    std::vector<unsigned> x;
+    std::vector<unsigned> y;
+};
+
+struct Edge{
+    unsigned from;
+    unsigned to;
+};
+
+double distance(const Graph& g, unsigned u, unsigned v) {
+    double dx = (double)g.x[u] - g.x[v];
+    double dy = (double)g.y[u] - g.y[v];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+/**
+ * Builds the adjacency arrays of @g from @edges. Each edge weighs
+ * between its length (rounded up, at least 1) and twice that.
+ */
+void buildGraph(Graph& g, const std::vector<Edge>& edges, std::mt19937& rng) {
+    g.offsets.assign(g.num_vertices + 1, 0);
+    for(const Edge& e : edges) {
+        ++g.offsets[e.from + 1];
+        ++g.offsets[e.to + 1];
+    }
+    for(unsigned u = 0; u < g.num_vertices; u++) {
+        g.offsets[u + 1] += g.offsets[u];
+    }
+
+    std::vector<unsigned> next(g.offsets.begin(), g.offsets.end() - 1);
+    g.targets.resize(2 * edges.size());
+    g.weights.resize(2 * edges.size());
+    for(const Edge& e : edges) {
+        unsigned length = std::max(1u, (unsigned)std::ceil(distance(g, e.from, e.to)));
+        unsigned weight = length + rng() % (length + 1);
+        g.targets[next[e.from]] = e.to;
+        g.weights[next[e.from]++] = weight;
+        g.targets[next[e.to]] = e.from;
+        g.weights[next[e.to]++] = weight;
+    }
+}
+
+Graph makeGrid(unsigned numVertices, std::mt19937& rng) {
+    unsigned side = std::max(2u, (unsigned)std::sqrt((double)numVertices));
+    Graph g;
+    g.num_vertices = side * side;
+    g.x.resize(g.num_vertices);
+    g.y.resize(g.num_vertices);
+
+    std::vector<Edge> edges;
+    edges.reserve(2 * g.num_vertices);
+    for(unsigned row = 0; row < side; row++) {
+        for(unsigned col = 0; col < side; col++) {
+            unsigned u = row * side + col;
+            g.x[u] = col * GRID_SPACING;
+            g.y[u] = row * GRID_SPACING;
+            if(col + 1 < side) {
+                edges.push_back({u, u + 1});
+            }
+            if(row + 1 < side) {
+                edges.push_back({u, u + side});
+            }
+        }
+    }
+    buildGraph(g, edges, rng);
+    return g;
+}
+
+void placeRandomly(Graph& g, std::mt19937& rng) {
+    g.x.resize(g.num_vertices);
+    g.y.resize(g.num_vertices);
+    for(unsigned u = 0; u < g.num_vertices; u++) {
+        g.x[u] = rng() % COORDINATE_RANGE;
+        g.y[u] = rng() % COORDINATE_RANGE;
+    }
+}
+
+Graph makeRandom(unsigned numVertices, unsigned degree, std::mt19937& rng) {
+    Graph g;
+    g.num_vertices = numVertices;
+    placeRandomly(g, rng);
+
+    std::vector<unsigned> order(numVertices);
+    for(unsigned u = 0; u < numVertices; u++) {
+        order[u] = u;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<Edge> edges;
+    edges.reserve((unsigned long long)numVertices * degree / 2 + numVertices);
+    for(unsigned i = 0; i + 1 < numVertices; i++) {
+        edges.push_back({order[i], order[i + 1]});
+    }
+    for(unsigned long long i = 0; i < (unsigned long long)numVertices * degree / 2; i++) {
+        unsigned u = rng() % numVertices;
+        unsigned v = rng() % numVertices;
+        if(u != v) {
+            edges.push_back({u, v});
+        }
+    }
+    buildGraph(g, edges, rng);
+    return g;
+}
+
+/**
+ * Each new vertex links to @degree / 2 earlier ones picked with
+ * probability proportional to their degree, which gives a power-law
+ * degree distribution.
+ */
+Graph makePowerLaw(unsigned numVertices, unsigned degree, std::mt19937& rng) {
+    Graph g;
+    g.num_vertices = numVertices;
+    placeRandomly(g, rng);
+
+    unsigned links = std::max(1u, degree / 2);
+    std::vector<Edge> edges;
+    std::vector<unsigned> endpoints;   // every vertex once per incident edge
+    edges.reserve((unsigned long long)numVertices * links);
+    endpoints.reserve(2ull * numVertices * links);
+    for(unsigned v = 1; v < numVertices; v++) {
+        for(unsigned i = 0; i < links && i < v; i++) {
+            unsigned u = endpoints.empty() ? 0 : endpoints[rng() % endpoints.size()];
+            edges.push_back({v, u});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    buildGraph(g, edges, rng);
+    return g;
+}
+
+std::vector<unsigned> dijkstra(const Graph& g, unsigned source, QueueStats& stats) {
+    std::vector<unsigned> dist(g.num_vertices, INF);
+    CountedQueue<unsigned, DistKey> pq(g.num_vertices);
+
+    dist[source] = 0;
+    pq.insert({0, source}, source);
+    while(!pq.empty()) {
+        unsigned u = pq.extractMin().value;
+        for(unsigned e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            unsigned v = g.targets[e];
+            unsigned new_dist = dist[u] + g.weights[e];
+            if(new_dist < dist[v]) {
+                if(dist[v] == INF) {
+                    pq.insert({new_dist, v}, v);
+                }else {
+                    pq.changeKey({dist[v], v}, {new_dist, v});
+                }
+                dist[v] = new_dist;
+            }
+        }
+    }
+    stats = pq.stats;
+    return dist;
+}
+
+/**
+ * Minimum spanning tree weight. The graphs are connected, so the tree
+ * from vertex 0 spans all of them.
+ */
+unsigned long long prim(const Graph& g, QueueStats& stats) {
+    std::vector<unsigned> cost(g.num_vertices, INF);
+    std::vector<bool> in_tree(g.num_vertices, false);
+    CountedQueue<unsigned, DistKey> pq(g.num_vertices);
+    unsigned long long total = 0;
+
+    cost[0] = 0;
+    pq.insert({0, 0}, 0);
+    while(!pq.empty()) {
+        unsigned u = pq.extractMin().value;
+        in_tree[u] = true;
+        total += cost[u];
+        for(unsigned e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            unsigned v = g.targets[e];
+            unsigned weight = g.weights[e];
+            if(!in_tree[v] && weight < cost[v]) {
+                if(cost[v] == INF) {
+                    pq.insert({weight, v}, v);
+                }else {
+                    pq.changeKey({cost[v], v}, {weight, v});
+                }
+                cost[v] = weight;
+            }
+        }
+    }
+    stats = pq.stats;
+    return total;
+}
+
+/**
+ * Shortest distance from @source to @target, or INF. The queue is
+ * ordered by distance so far plus the straight-line distance left,
+ * which never overestimates since no edge is shorter than its ends
+ * are apart.
+ */
+unsigned astar(const Graph& g, unsigned source, unsigned target, QueueStats& stats) {
+    std::vector<unsigned> dist(g.num_vertices, INF);
+    std::vector<bool> closed(g.num_vertices, false);
+    CountedQueue<unsigned, DistKey> pq(g.num_vertices);
+    auto estimate = [&](unsigned v) {
+        return (unsigned)distance(g, v, target);
+    };
+
+    dist[source] = 0;
+    pq.insert({estimate(source), source}, source);
+    while(!pq.empty()) {
+        unsigned u = pq.extractMin().value;
+        if(u == target) {
+            break;
+        }
+        closed[u] = true;
+        for(unsigned e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            unsigned v = g.targets[e];
+            unsigned new_dist = dist[u] + g.weights[e];
+            if(closed[v] || new_dist >= dist[v]) {
+                continue;
+            }
+            if(dist[v] == INF) {
+                pq.insert({new_dist + estimate(v), v}, v);
+            }else {
+                pq.changeKey({dist[v] + estimate(v), v}, {new_dist + estimate(v), v});
+            }
+            dist[v] = new_dist;
+        }
+    }
+    stats = pq.stats;
+    return dist[target];
+}
+
+/**
+ * Number of low key bits that hold the vertex in a packed key
+ * (dist << vertexBits) | vertex.
+ */
+unsigned vertexBits(const Graph& g) {
+    unsigned bits = 0;
+    while((1ull << bits) < g.num_vertices) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * dijkstra() on packed unsigned keys. Throws if a distance does not
+ * fit above the vertex bits.
+ */
+std::vector<unsigned> dijkstraPacked(const Graph& g, unsigned source, QueueStats& stats) {
+    const unsigned bits = vertexBits(g);
+    const unsigned max_dist = INF >> bits;
+    std::vector<unsigned> dist(g.num_vertices, INF);
+    PackedQueue<unsigned> pq(g.num_vertices);
+
+    dist[source] = 0;
+    pq.insert(source, source);
+    while(!pq.empty()) {
+        unsigned u = pq.extractMin();
+        for(unsigned e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            unsigned v = g.targets[e];
+            unsigned new_dist = dist[u] + g.weights[e];
+            if(new_dist < dist[v]) {
+                if(new_dist > max_dist) {
+                    throw std::runtime_error("distance does not fit in a packed key");
+                }
+                if(dist[v] == INF) {
+                    pq.insert(new_dist << bits | v, v);
+                }else {
+                    pq.decreaseKey(dist[v] << bits | v, (dist[v] - new_dist) << bits);
+                }
+                dist[v] = new_dist;
+            }
+        }
+    }
+    stats = pq.stats;
+    return dist;
+}
+
+/**
+ * prim() on packed unsigned keys. Throws if an edge weight does not
+ * fit above the vertex bits.
+ */
+unsigned long long primPacked(const Graph& g, QueueStats& stats) {
+    const unsigned bits = vertexBits(g);
+    const unsigned max_cost = INF >> bits;
+    std::vector<unsigned> cost(g.num_vertices, INF);
+    std::vector<bool> in_tree(g.num_vertices, false);
+    PackedQueue<unsigned> pq(g.num_vertices);
+    unsigned long long total = 0;
+
+    cost[0] = 0;
+    pq.insert(0, 0);
+    while(!pq.empty()) {
+        unsigned u = pq.extractMin();
+        in_tree[u] = true;
+        total += cost[u];
+        for(unsigned e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            unsigned v = g.targets[e];
+            unsigned weight = g.weights[e];
+            if(!in_tree[v] && weight < cost[v]) {
+                if(weight > max_cost) {
+                    throw std::runtime_error("edge weight does not fit in a packed key");
+                }
+                if(cost[v] == INF) {
+                    pq.insert(weight << bits | v, v);
+                }else {
+                    pq.decreaseKey(cost[v] << bits | v, (cost[v] - weight) << bits);
+                }
+                cost[v] = weight;
+            }
+        }
+    }
+    stats = pq.stats;
+    return total;
+}
+
+typedef std::pair<unsigned, unsigned> Item;
+typedef std::priority_queue<Item, std::vector<Item>, std::greater<Item>> LazyQueue;
+
+/**
+ * Reference Dijkstra with lazy deletion; stops early once @target
+ * is settled.
+ */
+std::vector<unsigned> referenceDijkstra(const Graph& g, unsigned source, unsigned target = INF) {
+    std::vector<unsigned> dist(g.num_vertices, INF);
+    LazyQueue pq;
+
+    dist[source] = 0;
+    pq.push({0, source});
+    while(!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if(d != dist[u]) {
+            continue;
+        }
+        if(u == target) {
+            break;
+        }
+        for(unsigned e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            unsigned v = g.targets[e];
+            if(d + g.weights[e] < dist[v]) {
+                dist[v] = d + g.weights[e];
+                pq.push({dist[v], v});
+            }
+        }
+    }
+    return dist;
+}
+
+unsigned long long referencePrim(const Graph& g) {
+    std::vector<bool> in_tree(g.num_vertices, false);
+    LazyQueue pq;
+    unsigned long long total = 0;
+
+    pq.push({0, 0});
+    while(!pq.empty()) {
+        auto [weight, u] = pq.top();
+        pq.pop();
+        if(in_tree[u]) {
+            continue;
+        }
+        in_tree[u] = true;
+        total += weight;
+        for(unsigned e = g.offsets[u]; e < g.offsets[u + 1]; e++) {
+            if(!in_tree[g.targets[e]]) {
+                pq.push({g.weights[e], g.targets[e]});
+            }
+        }
+    }
+    return total;
+}
+
+enum class EventType{
+    Arrival,
+    Departure,
+    Abandon,
+    SpeedChange
+};
+
+struct Event{
+    EventType type;
+    unsigned job;
+};
+
+struct SimResult{
+    unsigned long long served = 0;
+    unsigned long long abandoned = 0;
+    unsigned long long total_wait = 0;
+    unsigned long long end_time = 0;
+    QueueStats stats;
+
+    bool operator==(const SimResult& rhs) const {
+        return served == rhs.served && abandoned == rhs.abandoned && total_wait == rhs.total_wait
+               && end_time == rhs.end_time && stats.inserts == rhs.stats.inserts
+               && stats.extract_mins == rhs.stats.extract_mins
+               && stats.change_keys == rhs.stats.change_keys && stats.removes == rhs.stats.removes;
+    }
+};
+
+/**
+ * Runs @numJobs jobs through @numServers servers. Jobs arrive at
+ * random and wait in line when every server is busy; a waiting job
+ * leaves once its patience runs out, so serving it first cancels
+ * its abandon event. Every SPEED_PERIOD the servers switch between
+ * normal and double speed, which rescales the time left on every
+ * departure in progress.
+ *
+ * Times are integer ticks, so the same seed gives the same event
+ * sequence on any queue.
+ */
+template <typename Queue>
+SimResult simulate(unsigned numJobs, unsigned numServers, unsigned seed) {
+    const double MEAN_SERVICE = 100000;
+    const double MEAN_PATIENCE = 400000;
+    const unsigned long long SPEED_PERIOD = 1000000;
+    // slightly more work than the servers can do at normal speed
+    const double MEAN_INTERARRIVAL = MEAN_SERVICE / numServers / 1.1;
+
+    std::mt19937 rng(seed);
+    auto sample = [&rng](double mean) {
+        return 1 + (unsigned long long)std::exponential_distribution<double>(1 / mean)(rng);
+    };
+
+    Queue events(numJobs + numServers + 2);
+    SimResult result;
+    unsigned next_id = 0;
+    unsigned speed = 1;
+    unsigned arrived = 0;
+    std::vector<unsigned> idle;
+    std::vector<bool> busy(numServers, false);
+    std::vector<SimKey> departure(numServers);   // of the job on each busy server
+    std::vector<SimKey> abandon(numJobs);        // of each waiting job
+    std::vector<unsigned long long> arrival_time(numJobs);
+    std::vector<unsigned> server_of(numJobs);
+    std::vector<bool> waiting(numJobs, false);
+    std::queue<unsigned> line;
+
+    auto startService = [&](unsigned job, unsigned server, unsigned long long now) {
+        departure[server] = {now + (sample(MEAN_SERVICE) + speed - 1) / speed, next_id++};
+        server_of[job] = server;
+        busy[server] = true;
+        events.insert(departure[server], {EventType::Departure, job});
+        result.total_wait += now - arrival_time[job];
+    };
+
+    for(unsigned s = 0; s < numServers; s++) {
+        idle.push_back(numServers - 1 - s);
+    }
+    events.insert({sample(MEAN_INTERARRIVAL), next_id++}, {EventType::Arrival, 0});
+    events.insert({SPEED_PERIOD, next_id++}, {EventType::SpeedChange, 0});
+
+    while(result.served + result.abandoned < numJobs) {
+        KeyValuePair<Event, SimKey> next = events.extractMin();
+        unsigned long long now = next.key.time;
+        unsigned job = next.value.job;
+        result.end_time = now;
+
+        if(next.value.type == EventType::Arrival) {
+            arrival_time[job] = now;
+            if(!idle.empty()) {
+                startService(job, idle.back(), now);
+                idle.pop_back();
+            }else {
+                abandon[job] = {now + sample(MEAN_PATIENCE), next_id++};
+                events.insert(abandon[job], {EventType::Abandon, job});
+                waiting[job] = true;
+                line.push(job);
+            }
+            if(++arrived < numJobs) {
+                events.insert({now + sample(MEAN_INTERARRIVAL), next_id++}, {EventType::Arrival, arrived});
+            }
+        }else if(next.value.type == EventType::Departure) {
+            ++result.served;
+            unsigned server = server_of[job];
+            while(!line.empty() && !waiting[line.front()]) {   // skip jobs that left
+                line.pop();
+            }
+            if(line.empty()) {
+                busy[server] = false;
+                idle.push_back(server);
+            }else {
+                unsigned first = line.front();
+                line.pop();
+                waiting[first] = false;
+                events.remove(abandon[first]);
+                startService(first, server, now);
+            }
+        }else if(next.value.type == EventType::Abandon) {
+            ++result.abandoned;
+            waiting[job] = false;
+        }else {
+            unsigned new_speed = 3 - speed;
+            for(unsigned s = 0; s < numServers; s++) {
+                if(!busy[s]) {
+                    continue;
+                }
+                unsigned long long left = departure[s].time - now;
+                unsigned long long new_left = std::max(1ull, left * speed / new_speed);
+                if(new_left != left) {
+                    SimKey key = {now + new_left, departure[s].id};
+                    events.changeKey(departure[s], key);
+                    departure[s] = key;
+                }
+            }
+            speed = new_speed;
+            events.insert({now + SPEED_PERIOD, next_id++}, {EventType::SpeedChange, 0});
+        }
+    }
+    result.stats = events.stats;
+    return result;
+}
+
+std::string filter;
+
+bool selected(const std::string& workload, const std::string& graph) {
+    return filter.empty() || (workload + " " + graph).find(filter) != std::string::npos;
+}
+
+void report(const std::string& workload, const std::string& graph, unsigned long long n,
+            unsigned long long m, double generate_ms, double run_ms, double verify_ms,
+            const QueueStats& stats, unsigned long long result, bool ok) {
+    double queue_ms = stats.insert_ms + stats.extract_ms + stats.change_ms + stats.remove_ms;
+    std::cout << "{\"workload\":\"" << workload << "\",\"graph\":\"" << graph
+              << "\",\"n\":" << n << ",\"m\":" << m
+              << ",\"generate_ms\":" << generate_ms << ",\"run_ms\":" << run_ms
+              << ",\"insert_ms\":" << stats.insert_ms << ",\"extract_min_ms\":" << stats.extract_ms
+              << ",\"change_key_ms\":" << stats.change_ms << ",\"remove_ms\":" << stats.remove_ms
+              << ",\"other_ms\":" << run_ms - queue_ms << ",\"verify_ms\":" << verify_ms
+              << ",\"inserts\":" << stats.inserts << ",\"extract_mins\":" << stats.extract_mins
+              << ",\"change_keys\":" << stats.change_keys << ",\"removes\":" << stats.removes
+              << ",\"peak_rss_kb\":" << peakRssKb() << ",\"result\":" << result
+              << ",\"ok\":" << (ok ? "true" : "false") << "}" << std::endl;
+}
+
+void addStats(QueueStats& total, const QueueStats& stats) {
+    total.inserts += stats.inserts;
+    total.extract_mins += stats.extract_mins;
+    total.change_keys += stats.change_keys;
+    total.removes += stats.removes;
+    total.insert_ms += stats.insert_ms;
+    total.extract_ms += stats.extract_ms;
+    total.change_ms += stats.change_ms;
+    total.remove_ms += stats.remove_ms;
+}
+
+/**
+ * Runs the three graph workloads on @g and returns false if any of
+ * them disagrees with its reference.
+ */
+bool runGraph(const std::string& name, const Graph& g, double generate_ms, unsigned numQueries,
+              bool verify, std::mt19937& rng) {
+    bool all_ok = true;
+    unsigned long long edges = g.targets.size() / 2;
+
+    if(selected("dijkstra", name)) {
+        QueueStats stats;
+        auto start = Clock::now();
+        std::vector<unsigned> dist = dijkstra(g, 0, stats);
+        double run_ms = msSince(start);
+
+        unsigned long long sum = 0;
+        for(unsigned d : dist) {
+            sum += d == INF ? 0 : d;
+        }
+        bool ok = true;
+        start = Clock::now();
+        if(verify) {
+            ok = dist == referenceDijkstra(g, 0);
+        }
+        report("dijkstra", name, g.num_vertices, edges, generate_ms, run_ms, msSince(start), stats, sum, ok);
+        all_ok = all_ok && ok;
+    }
+
+    if(selected("prim", name)) {
+        QueueStats stats;
+        auto start = Clock::now();
+        unsigned long long total = prim(g, stats);
+        double run_ms = msSince(start);
+
+        bool ok = true;
+        start = Clock::now();
+        if(verify) {
+            ok = total == referencePrim(g);
+        }
+        report("prim", name, g.num_vertices, edges, generate_ms, run_ms, msSince(start), stats, total, ok);
+        all_ok = all_ok && ok;
+    }
+
+    if(selected("astar", name)) {
+        std::vector<std::pair<unsigned, unsigned>> queries(numQueries);
+        for(auto& query : queries) {
+            query = {(unsigned)(rng() % g.num_vertices), (unsigned)(rng() % g.num_vertices)};
+        }
+
+        QueueStats stats;
+        std::vector<unsigned> found;
+        auto start = Clock::now();
+        for(auto [source, target] : queries) {
+            QueueStats query_stats;
+            found.push_back(astar(g, source, target, query_stats));
+            addStats(stats, query_stats);
+        }
+        double run_ms = msSince(start);
+
+        unsigned long long sum = 0;
+        bool ok = true;
+        start = Clock::now();
+        for(unsigned i = 0; i < numQueries; i++) {
+            sum += found[i];
+            if(verify) {
+                ok = ok && found[i] == referenceDijkstra(g, queries[i].first, queries[i].second)[queries[i].second];
+            }
+        }
+        report("astar", name, g.num_vertices, edges, generate_ms, run_ms, msSince(start), stats, sum, ok);
+        all_ok = all_ok && ok;
+    }
+    return all_ok;
+}
+
+/**
+ * Runs the packed-key workloads on @g and returns false if either of
+ * them disagrees with its reference.
+ */
+bool runPacked(const std::string& name, const Graph& g, double generate_ms, bool verify) {
+    bool all_ok = true;
+    unsigned long long edges = g.targets.size() / 2;
+
+    if(selected("dijkstra-packed", name)) {
+        QueueStats stats;
+        auto start = Clock::now();
+        std::vector<unsigned> dist = dijkstraPacked(g, 0, stats);
+        double run_ms = msSince(start);
+
+        unsigned long long sum = 0;
+        for(unsigned d : dist) {
+            sum += d == INF ? 0 : d;
+        }
+        bool ok = true;
+        start = Clock::now();
+        if(verify) {
+            ok = dist == referenceDijkstra(g, 0);
+        }
+        report("dijkstra-packed", name, g.num_vertices, edges, generate_ms, run_ms, msSince(start), stats, sum, ok);
+        all_ok = all_ok && ok;
+    }
+
+    if(selected("prim-packed", name)) {
+        QueueStats stats;
+        auto start = Clock::now();
+        unsigned long long total = primPacked(g, stats);
+        double run_ms = msSince(start);
+
+        bool ok = true;
+        start = Clock::now();
+        if(verify) {
+            ok = total == referencePrim(g);
+        }
+        report("prim-packed", name, g.num_vertices, edges, generate_ms, run_ms, msSince(start), stats, total, ok);
+        all_ok = all_ok && ok;
+    }
+    return all_ok;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned num_vertices = 1u << 18;
+    unsigned degree = 8;
+    unsigned num_queries = 8;
+    unsigned num_jobs = 1u << 20;
+    unsigned num_servers = 64;
+    unsigned seed = 12345;
+    bool verify = true;
+
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--no-verify") {
+            verify = false;
+        }else if(i + 1 < argc && arg == "--filter") {
+            filter = argv[++i];
+        }else if(i + 1 < argc && (arg == "--vertices" || arg == "--degree" || arg == "--queries"
+                                  || arg == "--jobs" || arg == "--servers" || arg == "--seed")) {
+            unsigned value = std::stoul(argv[++i]);
+            if(arg == "--vertices") {
+                num_vertices = std::max(4u, value);
+            }else if(arg == "--degree") {
+                degree = std::max(2u, value);
+            }else if(arg == "--queries") {
+                num_queries = value;
+            }else if(arg == "--jobs") {
+                num_jobs = std::max(1u, value);
+            }else if(arg == "--servers") {
+                num_servers = std::max(1u, value);
+            }else {
+                seed = value;
+            }
+        }else {
+            std::cerr << "usage: " << argv[0] << " [--vertices N] [--degree D] [--queries K] [--jobs N]"
+                      << " [--servers C] [--seed S] [--filter TEXT] [--no-verify]\n";
+            return 1;
+        }
+    }
+
+    bool all_ok = true;
+    try {
+        std::mt19937 rng(seed);
+        const char* graphs[] = {"grid", "random", "powerlaw"};
+        for(const char* name : graphs) {
+            std::string graph = name;
+            if(!selected("dijkstra", graph) && !selected("prim", graph) && !selected("astar", graph)) {
+                continue;
+            }
+            auto start = Clock::now();
+            Graph g = graph == "grid" ? makeGrid(num_vertices, rng)
+                      : graph == "random" ? makeRandom(num_vertices, degree, rng)
+                      : makePowerLaw(num_vertices, degree, rng);
+            double generate_ms = msSince(start);
+            all_ok = runGraph(graph, g, generate_ms, num_queries, verify, rng) && all_ok;
+        }
+
+        if(selected("dijkstra-packed", "grid") || selected("prim-packed", "grid")) {
+            auto start = Clock::now();
+            Graph g = makeGrid(std::min(num_vertices, PACKED_MAX_VERTICES), rng);
+            double generate_ms = msSince(start);
+            all_ok = runPacked("grid", g, generate_ms, verify) && all_ok;
+        }
+
+        if(selected("simulation", "servers")) {
+            auto start = Clock::now();
+            SimResult result = simulate<CountedQueue<Event, SimKey>>(num_jobs, num_servers, seed);
+            double run_ms = msSince(start);
+
+            bool ok = true;
+            start = Clock::now();
+            if(verify) {
+                ok = result == simulate<MapQueue<Event, SimKey>>(num_jobs, num_servers, seed);
+            }
+            report("simulation", "servers", num_servers, num_jobs, 0, run_ms, msSince(start),
+                   result.stats, result.served * 1000003ull + result.total_wait, ok);
+            all_ok = all_ok && ok;
+        }
+    }catch(const std::runtime_error& e) {   // a failed queue operation
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#include "expiring_cache.hpp"
+#include <iostream>
+int main()
+{
+    ExpiringCache<std::string> cache(100, 64);
+    cache.put(1, "door", 10, 0, 16);
+    cache.put(2, "window", 5, 0, 16);
+    cache.put(3, "house", 20, 0, 16);
+    std::cout << (cache.get(2, 4) != nullptr) << '\n';   // now expires at 9
+    std::cout << cache.expireUntil(10) << ' ' << cache.numElements() << '\n';
+    cache.put(4, "bed", 30, 10, 50);   // over budget: evicts key 3
+    std::cout << (cache.peek(3) == nullptr) << ' ' << cache.bytesUsed() << '\n';
+}
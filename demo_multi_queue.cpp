@@ -0,0 +1,23 @@
+#include "multi_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+int main()
+{
+    MultiQueue<unsigned> mq(8, 1000, true);
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < 4; t++) {
+        workers.emplace_back([&mq, t]() {
+            for(unsigned i = 0; i < 100; i++) {
+                mq.insert(t * 100 + i + 10, t);
+            }
+        });
+    }
+    for(std::thread& w : workers) {
+        w.join();
+    }
+    std::cout << mq.numElements() << '\n';
+    mq.decreaseKey(10, 5);
+    std::cout << mq.contains(5) << ' ' << mq.contains(10) << '\n';
+    std::cout << mq.extractMin()->key << '\n';
+}
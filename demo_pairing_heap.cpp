@@ -0,0 +1,16 @@
+#include "pairing_heap.hpp"
+#include <iostream>
+int main()
+{
+    PairingHeap<std::string> a;
+    a.insert(15, "window");
+    a.insert(10, "door");
+    PairingHeap<std::string> b;
+    b.insert(7, "sleep");
+    b.insert(10, "table");
+    a.meld(b);
+    std::cout << a.numElements() << ' ' << b.numElements() << '\n';
+    std::cout << *a.getMinKey() << ' ' << *a.getMinValue() << '\n';
+    a.decreaseKey(15, 10);
+    std::cout << *a.getMinKey() << ' ' << *a.get(10) << '\n';
+}
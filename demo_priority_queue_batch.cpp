@@ -0,0 +1,33 @@
+#include "priority_queue.hpp"
+#include <iostream>
+int main()
+{
+    PriorityQueue<std::string> p(20);
+    p.insert(1, "door");
+    p.insert(3, "window");
+    p.insert(9, "house");
+    p.insert(2, "bed");
+    p.insert(4, "sleep");    // heap is 1 2 9 3 4
+    std::cout << p.extractMin()->value << '\n';   // door
+
+    std::vector<KeyValuePair<std::string, unsigned>> out;
+    p.insert(1, "door");     // heap is 1 2 9 4 3
+    std::cout << p.popBatch(4, out) << ' ' << *p.getMinKey() << '\n';   // takes the tail 3
+    for(const auto& pair : out) {
+        std::cout << pair.key << ' ' << pair.value << '\n';
+    }
+
+    p.insert(5, "table");
+    out.clear();
+    std::cout << p.popBatch(2, out) << ' ' << p.numElements() << '\n';   // k = size
+    p.insert(6, "chair");
+    out.clear();
+    std::cout << p.popBatch(10, out) << ' ' << p.numElements() << '\n';  // k > size
+    std::cout << p.extractMin().has_value() << '\n';
+
+    p.insert(7, "lamp");
+    p.insert(8, "rug");
+    std::cout << (p.replaceMin(8, "sofa") == std::nullopt) << '\n';   // 8 is not the root
+    std::cout << p.replaceMin(7, "desk")->value << '\n';              // the root's own key
+    std::cout << *p.getMinKey() << ' ' << *p.getMinValue() << '\n';
+}
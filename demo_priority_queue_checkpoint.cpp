@@ -0,0 +1,49 @@
+#include "priority_queue.hpp"
+#include <iostream>
+#include <sstream>
+int main()
+{
+    PriorityQueue<unsigned> p(20);   // raw bytes
+    p.insert(15, 150);
+    p.insert(10, 100);
+    p.insert(20, 200);
+    std::stringstream raw;
+    p.save(raw);
+    PriorityQueue<unsigned> p2 = PriorityQueue<unsigned>::load(raw);
+    std::cout << p2.numElements() << ' ' << *p2.getMinKey() << ' ' << *p2.getMinValue() << '\n';
+
+    PriorityQueue<std::string> q(20);   // length-prefixed strings
+    q.insert(15, "window");
+    q.insert(10, "door");
+    q.insert(20, "house");
+    std::stringstream text;
+    q.save(text);
+    std::string bytes = text.str();
+    PriorityQueue<std::string> q2 = PriorityQueue<std::string>::load(text);
+    std::cout << q2.numElements() << ' ' << *q2.getMinValue() << ' ' << *q2.get(20) << '\n';
+
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 3));
+    try {
+        PriorityQueue<std::string>::load(truncated);
+    }catch(const std::runtime_error& e) {
+        std::cout << e.what() << '\n';
+    }
+
+    std::stringstream duplicate;   // two elements with key 10
+    writeBinary(duplicate, PQ_CHECKPOINT_MAGIC);
+    writeBinary(duplicate, PQ_CHECKPOINT_VERSION);
+    writeBinary(duplicate, 0u);
+    writeBinary(duplicate, (unsigned)sizeof(unsigned));
+    writeBinary(duplicate, (unsigned)sizeof(std::string));
+    writeBinary(duplicate, 20u);
+    writeBinary(duplicate, 2u);
+    writeBinary(duplicate, 10u);
+    writeBinary(duplicate, std::string("door"));
+    writeBinary(duplicate, 10u);
+    writeBinary(duplicate, std::string("bed"));
+    try {
+        PriorityQueue<std::string>::load(duplicate);
+    }catch(const std::runtime_error& e) {
+        std::cout << e.what() << '\n';
+    }
+}
@@ -0,0 +1,40 @@
+#include "priority_queue.hpp"
+#include <iostream>
+
+struct Priority{
+    unsigned level;
+    unsigned deadline;
+
+    bool operator==(const Priority& rhs) const {
+        return level == rhs.level && deadline == rhs.deadline;
+    }
+    bool operator<(const Priority& rhs) const {   // earlier deadline breaks ties
+        return level != rhs.level ? level < rhs.level : deadline < rhs.deadline;
+    }
+};
+
+template <>
+struct KeyHash<Priority>{
+    std::size_t operator()(const Priority& key) const {
+        return key.level * 31u + key.deadline;
+    }
+};
+
+int main()
+{
+    PriorityQueue<std::string, unsigned, std::greater<unsigned>> max_heap(20);
+    max_heap.insert(15, "window");
+    max_heap.insert(10, "door");
+    max_heap.insert(20, "house");
+    std::cout << *max_heap.getMinKey() << ' ' << *max_heap.getMinValue() << '\n';
+    max_heap.changeKey(10, 30);
+    std::cout << *max_heap.getMinKey() << ' ' << *max_heap.getMinValue() << '\n';
+
+    PriorityQueue<std::string, Priority> jobs(20);
+    jobs.insert({1, 50}, "backup");
+    jobs.insert({1, 20}, "report");
+    jobs.insert({2, 10}, "cleanup");
+    std::cout << *jobs.getMinValue() << '\n';
+    jobs.changeKey({2, 10}, {0, 10});
+    std::cout << *jobs.getMinValue() << '\n';
+}
@@ -0,0 +1,30 @@
+#include "priority_queue.hpp"
+#include <iostream>
+int main()
+{
+    PriorityQueue<std::string> p(20);
+    const char* words[] = {"door", "window", "house", "bed", "sleep", "table", "chair", "lamp"};
+    for(unsigned i = 0; i < 8; i++) {
+        p.insert(10 * (i + 1), words[i]);
+    }
+
+    std::cout << p.updateKeys({{80, 5}}) << ' ' << *p.getMinValue() << '\n';   // re-sift: 1 * 3 < 8
+    std::cout << p.updateKeys({{10, 95}, {20, 96}, {30, 1}}) << ' '
+              << *p.getMinValue() << '\n';                                   // heapify: 3 * 3 >= 8
+    std::cout << p.updateKeys({{40, 41}, {41, 2}}) << ' ' << *p.get(2) << '\n';   // 40 -> 41 -> 2
+    std::cout << p.updateKeys({{50, 2}, {60, 60}, {70, 70}}) << '\n';        // duplicate, unchanged
+
+    p.setLazyUpdates(true);
+    std::cout << p.updateKeys({{1, 99}}) << '\n';   // buffered only
+    std::cout << *p.getMinKey() << ' ' << *p.getMinValue() << '\n';   // applied first
+    p.setLazyUpdates(false);
+
+    PriorityQueue<std::string> q(4);
+    q.insert(7, "rug");
+    q.insert(8, "sofa");
+    q.setLazyUpdates(true);
+    q.updateKeys({{7, 3}});
+    PriorityQueue<std::string> sum = p + q;   // q's pending update is applied to a copy
+    std::cout << sum.numElements() << ' ' << *sum.getMinKey() << ' ' << *sum.getMinValue() << '\n';
+    std::cout << p.meld(q) << ' ' << p.numElements() << ' ' << *p.getMinKey() << '\n';
+}
@@ -0,0 +1,15 @@
+#include "radix_heap.hpp"
+#include <iostream>
+int main()
+{
+    RadixHeap<std::string> r(20);
+    r.insert(15, "window");
+    r.insert(10, "door");
+    r.insert(20, "house");
+    std::cout << *r.getMinValue() << '\n';
+    r.deleteMin();
+    r.insert(12, "bed");
+    r.decreaseKey(20, 9);
+    std::cout << *r.getMinKey() << ' ' << *r.getMinValue() << '\n';
+    std::cout << r.numElements() << '\n';
+}
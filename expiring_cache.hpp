@@ -0,0 +1,150 @@
+#ifndef EXPIRING_CACHE_HPP
+#define EXPIRING_CACHE_HPP
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "hash_table.hpp"
+
+/**
+ * Implementation of a cache that maps unsigned keys to instances of
+ * ValueType, where every entry expires a fixed time-to-live (TTL)
+ * after it was last written or read, and the total size of the
+ * entries is kept within a byte budget.
+ *
+ * Entries live in a slot array. A hash table maps each key to its
+ * slot, and a binary min heap of slot numbers orders the entries by
+ * expiry time. Each entry records its own position in the heap, so
+ * once a key has been found in the hash table (one lookup), the entry
+ * can be moved in the heap without any further hashing.
+ *
+ * Time is whatever unit the caller uses (ticks, milliseconds, ...)
+ * and is always passed in as @now; the cache never reads a clock.
+ * @now does not have to increase from one call to the next.
+ *
+ * get() extends an entry's expiry to now + its TTL, so with a single
+ * TTL for all entries the heap order is exactly least recently used
+ * order. When the byte budget or the maximum number of entries would
+ * be exceeded, the entry that expires first is evicted.
+ *
+ * get(), put() and remove() run in "constant time" + logarithmic time.
+ * expireUntil() runs in logarithmic time per expired entry.
+ */
+
+template <typename ValueType>
+struct CacheEntry{
+    unsigned key;
+    ValueType value;
+    unsigned long long expires_at;
+    unsigned long long ttl;
+    std::size_t bytes;
+    unsigned heap_pos;
+};
+
+template <typename ValueType>
+class ExpiringCache
+{
+public:
+    /**
+     * Creates a cache that can hold at most @maxSize entries whose
+     * sizes add up to at most @byteBudget bytes.
+     *
+     * Throws std::runtime_error if @maxSize or @byteBudget is 0.
+     */
+    ExpiringCache(unsigned maxSize, std::size_t byteBudget) : ht(HashTable<unsigned>(nextPrime(maxSize))) {
+        if(maxSize == 0) {
+            throw std::runtime_error("Max Size can't be zero");
+        }
+        if(byteBudget == 0) {
+            throw std::runtime_error("Byte budget can't be zero");
+        }
+        max_size = maxSize;
+        byte_budget = byteBudget;
+        bytes_used = 0;
+        heap.reserve(maxSize+1);
+        heap.push_back(0);   // the heap starts at index 1
+    }
+
+    /**
+     * All of these must run in constant time.
+     */
+    unsigned numElements() const {
+        return heap.size() - 1;
+    }
+    unsigned maxSize() const {
+        return max_size;
+    }
+    std::size_t bytesUsed() const {
+        return bytes_used;
+    }
+    std::size_t byteBudget() const {
+        return byte_budget;
+    }
+
+    /**
+     * Returns the address of the value cached under @key and extends
+     * its expiry to @now + its TTL.
+     *
+     * Returns null pointer if @key is not cached or has expired at
+     * @now (an expired entry is removed).
+     *
+     * The pointer may be invalidated if the cache is modified.
+     */
+    ValueType* get(unsigned key, unsigned long long now);
+
+    /**
+     * Returns the address of the value cached under @key without
+     * touching it, or null pointer if @key is not cached. Expiry is
+     * not checked.
+     */
+    const ValueType* peek(unsigned key) const;
+
+    /**
+     * Caches @value under @key, occupying @bytes bytes of the budget,
+     * expiring at @now + @ttl. If @key is already cached, its entry
+     * is replaced.
+     *
+     * Before the new entry is added, the entries that expire first
+     * are evicted until it fits in the byte budget and maximum size.
+     *
+     * Returns true if success.
+     * Returns false if @bytes alone exceeds the byte budget
+     * (in which case, nothing is performed).
+     */
+    bool put(unsigned key, const ValueType& value, unsigned long long ttl,
+             unsigned long long now, std::size_t bytes = sizeof(ValueType));
+
+    /**
+     * Removes the entry that has key @key.
+     *
+     * Returns true if success.
+     * Returns false if @key not found.
+     */
+    bool remove(unsigned key);
+
+    /**
+     * Removes every entry that has expired at @now, i.e. whose expiry
+     * time is at most @now.
+     *
+     * Returns the number of entries removed.
+     */
+    unsigned expireUntil(unsigned long long now);
+
+private:
+    std::vector<CacheEntry<ValueType>> entries;
+    std::vector<unsigned> free_slots;
+    std::vector<unsigned> heap;
+    HashTable<unsigned> ht;
+    unsigned max_size;
+    std::size_t byte_budget;
+    std::size_t bytes_used;
+
+    bool earlier(unsigned pos_1, unsigned pos_2) const;
+    void place(unsigned pos, unsigned slot);
+    void siftUp(unsigned pos);
+    void siftDown(unsigned pos);
+    void erase(unsigned slot);
+};
+
+#include "expiring_cache.inl"
+#endif  // EXPIRING_CACHE_HPP
@@ -0,0 +1,140 @@
+template <typename ValueType>
+bool ExpiringCache<ValueType>::earlier(unsigned pos_1, unsigned pos_2) const {
+    return entries[heap[pos_1]].expires_at < entries[heap[pos_2]].expires_at;
+}
+
+template <typename ValueType>
+void ExpiringCache<ValueType>::place(unsigned pos, unsigned slot) {
+    heap[pos] = slot;
+    entries[slot].heap_pos = pos;
+}
+
+template <typename ValueType>
+void ExpiringCache<ValueType>::siftUp(unsigned pos) {
+    unsigned slot = heap[pos];
+    unsigned long long expires_at = entries[slot].expires_at;
+
+    while(pos > 1 && expires_at < entries[heap[pos/2]].expires_at) {
+        place(pos, heap[pos/2]);
+        pos /= 2;
+    }
+    place(pos, slot);
+}
+
+template <typename ValueType>
+void ExpiringCache<ValueType>::siftDown(unsigned pos) {
+    unsigned slot = heap[pos];
+    unsigned long long expires_at = entries[slot].expires_at;
+    unsigned size = heap.size() - 1;
+
+    while(pos*2 <= size) {
+        unsigned child = pos*2;
+        if(child+1 <= size && earlier(child+1, child)) {
+            ++child;
+        }
+        if(!(entries[heap[child]].expires_at < expires_at)) {
+            break;
+        }
+        place(pos, heap[child]);
+        pos = child;
+    }
+    place(pos, slot);
+}
+
+template <typename ValueType>
+void ExpiringCache<ValueType>::erase(unsigned slot) {
+    unsigned pos = entries[slot].heap_pos;
+    unsigned last = heap.back();
+    heap.pop_back();
+    if(pos < heap.size()) {
+        place(pos, last);
+        siftUp(pos);
+        siftDown(entries[last].heap_pos);
+    }
+
+    ht.remove(entries[slot].key);
+    bytes_used -= entries[slot].bytes;
+    entries[slot].value = ValueType();   // release whatever the value holds
+    free_slots.push_back(slot);
+}
+
+template <typename ValueType>
+ValueType* ExpiringCache<ValueType>::get(unsigned key, unsigned long long now) {
+    const unsigned* found = ht.get(key);
+    if(found == nullptr) {
+        return nullptr;
+    }
+
+    unsigned slot = *found;
+    CacheEntry<ValueType>& entry = entries[slot];
+    if(entry.expires_at <= now) {
+        erase(slot);
+        return nullptr;
+    }
+    entry.expires_at = now + entry.ttl;
+    // an earlier @now than last time moves the expiry up, not down
+    siftUp(entry.heap_pos);
+    siftDown(entry.heap_pos);
+    return &(entry.value);
+}
+
+template <typename ValueType>
+const ValueType* ExpiringCache<ValueType>::peek(unsigned key) const {
+    const unsigned* found = ht.get(key);
+    if(found == nullptr) {
+        return nullptr;
+    }
+    return &(entries[*found].value);
+}
+
+template <typename ValueType>
+bool ExpiringCache<ValueType>::put(unsigned key, const ValueType& value, unsigned long long ttl,
+                                   unsigned long long now, std::size_t bytes) {
+    if(bytes > byte_budget) {
+        return false;
+    }
+
+    const unsigned* found = ht.get(key);
+    if(found != nullptr) {
+        erase(*found);
+    }
+    while(heap.size() - 1 == max_size || bytes_used + bytes > byte_budget) {
+        erase(heap[1]);
+    }
+
+    unsigned slot = 0;
+    if(free_slots.empty()) {
+        slot = entries.size();
+        entries.push_back({key, value, now + ttl, ttl, bytes, 0});
+    }else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        entries[slot] = {key, value, now + ttl, ttl, bytes, 0};
+    }
+    ht.insert(key, slot);
+    bytes_used += bytes;
+    heap.push_back(slot);
+    place(heap.size() - 1, slot);
+    siftUp(heap.size() - 1);
+    return true;
+}
+
+template <typename ValueType>
+bool ExpiringCache<ValueType>::remove(unsigned key) {
+    const unsigned* found = ht.get(key);
+    if(found == nullptr) {
+        return false;
+    }
+    erase(*found);
+    return true;
+}
+
+template <typename ValueType>
+unsigned ExpiringCache<ValueType>::expireUntil(unsigned long long now) {
+    unsigned num_expired = 0;
+    while(heap.size() > 1 && entries[heap[1]].expires_at <= now) {
+        erase(heap[1]);
+        ++num_expired;
+    }
+    return num_expired;
+}
@@ -1,16 +1,19 @@
 #include <iostream>
 #include <memory>
 #include <cmath>
+#include <functional>
 
 #ifndef HASH_TABLE_HPP
 #define HASH_TABLE_HPP
 
 /**
  * Implementation of a hash table that stores key-value
- * pairs mapping unsigned integers to instances of
- * ValueType.
+ * pairs mapping keys (unsigned integers unless KeyType says
+ * otherwise) to instances of ValueType.
  *
- * Hash function: key % tableSize
+ * Hash function: KeyHash<KeyType>()(key) % tableSize, which is
+ * key % tableSize for unsigned keys. Other key types need
+ * operator== and either a std::hash or a KeyHash specialization.
  * Collision resolution: quadratic probing.
  * Non-unique keys are not supported.
  *
@@ -38,6 +41,13 @@
  * from the "old table" to the "new/larger table" in the
  * order in which they appear in the old table, and then
  * the new element is finally inserted.
+ *
+ * Deleted buckets keep probe chains intact but are never emptied
+ * by insert(), so if live plus deleted buckets would reach half of
+ * the table the deleted ones are purged first: by the rehash above
+ * if the table is more than a quarter full, otherwise by rebuilding
+ * it at its current size. Without this a long run of insert/remove
+ * churn fills every bucket and get() on a missing key never stops.
  */
 
 enum class Status{
@@ -46,17 +56,54 @@ enum class Status{
     Occupied
 };
 
-template <typename ValueType>
+template <typename KeyType>
+struct KeyHash{
+    std::size_t operator()(const KeyType& key) const {
+        return std::hash<KeyType>()(key);
+    }
+};
+
+template <>
+struct KeyHash<unsigned>{
+    std::size_t operator()(unsigned key) const {
+        return key;
+    }
+};
+
+/**
+ * Returns whether @n has no divisor from 2 up to its square root.
+ * Shared by every structure here that sizes a HashTable.
+ */
+inline bool isPrime(unsigned n) {
+    for(unsigned i = 2; i <= std::sqrt(n); i++) {
+        if(n % i == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the smallest prime that is at least @n.
+ */
+inline unsigned nextPrime(unsigned n) {
+    while(!isPrime(n)) {
+        ++n;
+    }
+    return n;
+}
+
+template <typename ValueType, typename KeyType = unsigned>
 struct Pair{
-    unsigned key;
+    KeyType key;
     ValueType value;
     Status stat = Status::Empty;
 };
 
-template <typename ValueType>
-bool isSamePair(Pair<ValueType> p1, Pair<ValueType> p2);
+template <typename ValueType, typename KeyType>
+bool isSamePair(Pair<ValueType, KeyType> p1, Pair<ValueType, KeyType> p2);
 
-template <typename ValueType>
+template <typename ValueType, typename KeyType = unsigned>
 class HashTable
 {
 public:
@@ -65,7 +112,7 @@ public:
      * buckets/slots.
      *
      * Throws std::runtime_error if @tableSize is 0 or not
-     * prime.
+     * prime (perfect squares such as 9 included).
      */
 
     explicit HashTable(unsigned tableSize) {
@@ -74,9 +121,10 @@ public:
         }else if(!isPrime(tableSize)) {
             throw std::runtime_error("Table size can't be non prime");
         } 
-        hash_table = std::make_unique<Pair<ValueType>[]>(tableSize);
+        hash_table = std::make_unique<Pair<ValueType, KeyType>[]>(tableSize);
         table_size = tableSize;
         num_element = 0;
+        num_deleted = 0;
     }
 
     ~HashTable(){}
@@ -88,7 +136,8 @@ public:
     HashTable(const HashTable& rhs) {   // copy only, rhs is not deallocated
         table_size = rhs.table_size;
         num_element = rhs.num_element;
-        hash_table = std::make_unique<Pair<ValueType>[]>(table_size);  //don't use -> because it's reference not ptr, treat it just like a object
+        num_deleted = rhs.num_deleted;
+        hash_table = std::make_unique<Pair<ValueType, KeyType>[]>(table_size);  //don't use -> because it's reference not ptr, treat it just like a object
         for(unsigned i = 0; i < tableSize(); i++) {
             hash_table[i] = rhs.hash_table[i];
         }
@@ -96,7 +145,8 @@ public:
     HashTable& operator=(const HashTable& rhs) {
         table_size = rhs.table_size;
         num_element = rhs.num_element;
-        hash_table = std::make_unique<Pair<ValueType>[]>(table_size);  //don't use -> because it's reference not ptr, treat it just like a object
+        num_deleted = rhs.num_deleted;
+        hash_table = std::make_unique<Pair<ValueType, KeyType>[]>(table_size);  //don't use -> because it's reference not ptr, treat it just like a object
         for(unsigned i = 0; i < tableSize(); i++) {
             hash_table[i] = rhs.hash_table[i];
         }
@@ -111,16 +161,20 @@ public:
     HashTable(HashTable&& rhs) noexcept {   // move semantic, rhs is deallocated
         table_size = rhs.table_size;
         num_element = rhs.num_element;
+        num_deleted = rhs.num_deleted;
         hash_table = std::move(rhs.hash_table); // turns rhs.hash_table to "move from" state that allows the change of ownership to happen.
         rhs.hash_table = nullptr; 
         rhs.num_element = 0;
+        rhs.num_deleted = 0;
     }
     HashTable& operator=(HashTable&& rhs) noexcept {
         table_size = rhs.tableSize();
         num_element = rhs.numElements();
+        num_deleted = rhs.num_deleted;
         hash_table = std::move(rhs.hash_table);
         rhs.hash_table = nullptr;
         rhs.num_element = 0;
+        rhs.num_deleted = 0;
         return *this;
     }
 
@@ -144,7 +198,7 @@ public:
      * go for it.
      */
     friend std::ostream& operator<<(std::ostream& os,
-                                    const HashTable<ValueType>& ht)
+                                    const HashTable<ValueType, KeyType>& ht)
     {
         // TODO: Implement this method.
         for(unsigned i = 0; i < ht.tableSize(); i++) {
@@ -168,7 +222,7 @@ public:
      * Returns false if @key is already in the table
      * (in which case, the insertion is not performed).
      */
-    bool insert(unsigned key, const ValueType& value);
+    bool insert(const KeyType& key, const ValueType& value);
 
     /**
      * Finds the value corresponding to the given key
@@ -178,8 +232,8 @@ public:
      *
      * Returns null pointer if @key is not in the table.
      */
-    ValueType* get(unsigned key);
-    const ValueType* get(unsigned key) const;
+    ValueType* get(const KeyType& key);
+    const ValueType* get(const KeyType& key) const;
 
     /**
      * Updates the key-value pair with key @key to be
@@ -190,7 +244,7 @@ public:
      * Returns true if success.
      * Returns false if @key is not in the table.
      */
-    bool update(unsigned key, const ValueType& newValue);
+    bool update(const KeyType& key, const ValueType& newValue);
 
     /**
      * Deletes the element that has the given key.
@@ -200,7 +254,7 @@ public:
      * Returns true if success.
      * Returns false if @key not found.
      */
-    bool remove(unsigned key);
+    bool remove(const KeyType& key);
 
     /**
      * Deletes all elements that have the given value.
@@ -210,7 +264,7 @@ public:
     unsigned removeAllByValue(const ValueType& value);
 
     /**
-     * Two instances of HashTable<ValueType> are considered 
+     * Two instances of HashTable are considered 
      * equal if they contain the same elements, even if those
      * elements are in different buckets (i.e. even if the
      * hash tables have different sizes).
@@ -228,13 +282,15 @@ public:
 
 private:
     // TODO: Your members here.
-    std::unique_ptr<Pair<ValueType>[]> hash_table;
+    std::unique_ptr<Pair<ValueType, KeyType>[]> hash_table;
     unsigned table_size;
     unsigned num_element;
+    unsigned num_deleted;
 
-    bool isPrime(unsigned table_size);
-    const void quadraticProb(unsigned& i, unsigned& pos, unsigned key) const;
-    void rehash(unsigned key, const ValueType& value);
+    void quadraticProb(unsigned& i, unsigned& pos, unsigned home) const;
+    unsigned hashOf(const KeyType& key) const;
+    void rehash(const KeyType& key, const ValueType& value);
+    void purgeDeleted();
 };
 
 #include "hash_table.inl"
@@ -1,15 +1,5 @@
-template <typename ValueType>
-bool HashTable<ValueType>::isPrime(unsigned table_size) {
-    for(unsigned i = 2; i < std::sqrt(table_size); i++) {
-        if(table_size % i == 0) {
-            return false;
-        }
-    }
-    return true;
-}
-
-template <typename ValueType>
-bool isSamePair(Pair<ValueType> p1, Pair<ValueType> p2) {
+template <typename ValueType, typename KeyType>
+bool isSamePair(Pair<ValueType, KeyType> p1, Pair<ValueType, KeyType> p2) {
     if(p1.key == p2.key && p1.value == p2.value && p1.stat == p2.stat) {
         return true;
     }
@@ -17,19 +7,25 @@ bool isSamePair(Pair<ValueType> p1, Pair<ValueType> p2) {
 }
 
 
-template <typename ValueType> 
-const void HashTable<ValueType>::quadraticProb(unsigned& i, unsigned& pos, unsigned key) const {
-    pos = key % table_size + pow(i, 2);
+template <typename ValueType, typename KeyType>
+unsigned HashTable<ValueType, KeyType>::hashOf(const KeyType& key) const {
+    return KeyHash<KeyType>()(key) % table_size;
+}
+
+template <typename ValueType, typename KeyType>
+void HashTable<ValueType, KeyType>::quadraticProb(unsigned& i, unsigned& pos, unsigned home) const {
+    pos = home + pow(i, 2);
     ++i;
     if(pos > table_size-1) {
         pos %= (table_size);
     }
 } 
 
-template <typename ValueType>
-void HashTable<ValueType>::rehash(unsigned key, const ValueType& value) {
+template <typename ValueType, typename KeyType>
+void HashTable<ValueType, KeyType>::rehash(const KeyType& key, const ValueType& value) {
     num_element = 0;
-    std::unique_ptr<Pair<ValueType>[]> temp;  //make a copy of old table 
+    num_deleted = 0;
+    std::unique_ptr<Pair<ValueType, KeyType>[]> temp;  //make a copy of old table 
 
     unsigned temp_size = table_size;
     table_size = table_size * 2 + 1;
@@ -37,9 +33,9 @@ void HashTable<ValueType>::rehash(unsigned key, const ValueType& value) {
         ++table_size;
     }
     // don't use function tableSize();
-    temp = std::make_unique<Pair<ValueType>[]>(temp_size);
+    temp = std::make_unique<Pair<ValueType, KeyType>[]>(temp_size);
     temp = std::move(hash_table);
-    hash_table = std::make_unique<Pair<ValueType>[]>(table_size);
+    hash_table = std::make_unique<Pair<ValueType, KeyType>[]>(table_size);
     
     for(unsigned i = 0; i < temp_size; i++) {
         if(temp[i].stat == Status::Occupied) {
@@ -50,22 +46,44 @@ void HashTable<ValueType>::rehash(unsigned key, const ValueType& value) {
 
 }
 
-template <typename ValueType>
-bool HashTable<ValueType>::insert(unsigned key, const ValueType& value) {
+template <typename ValueType, typename KeyType>
+void HashTable<ValueType, KeyType>::purgeDeleted() {
+    std::unique_ptr<Pair<ValueType, KeyType>[]> temp = std::move(hash_table);
+    hash_table = std::make_unique<Pair<ValueType, KeyType>[]>(table_size);
+    num_element = 0;
+    num_deleted = 0;
+
+    for(unsigned i = 0; i < table_size; i++) {
+        if(temp[i].stat == Status::Occupied) {
+            insert(temp[i].key, temp[i].value);
+        }
+    }
+}
+
+template <typename ValueType, typename KeyType>
+bool HashTable<ValueType, KeyType>::insert(const KeyType& key, const ValueType& value) {
     unsigned i = 1;
-    Pair<ValueType> pair = {key, value, Status::Occupied};
+    Pair<ValueType, KeyType> pair = {key, value, Status::Occupied};
 
     if(get(key) != nullptr) {
         return false;
     }
 
     double lamb = (double)(num_element+1) / table_size;
-    if(lamb > 0.5) {
+    double used = (double)(num_element+num_deleted+1) / table_size;
+    if(lamb > 0.5 || (used > 0.5 && lamb > 0.25)) {
        rehash(key, value);
     }else {
-        unsigned pos = key % table_size;
+        if(used > 0.5) {
+            purgeDeleted();
+        }
+        unsigned home = hashOf(key);
+        unsigned pos = home;
         while(hash_table[pos].stat == Status::Occupied) {
-            quadraticProb(i, pos, key);
+            quadraticProb(i, pos, home);
+        }
+        if(hash_table[pos].stat == Status::Deleted) {
+            --num_deleted;
         }
         hash_table[pos] = pair;
         ++num_element;
@@ -73,34 +91,36 @@ bool HashTable<ValueType>::insert(unsigned key, const ValueType& value) {
     return true;
 }
 
-template <typename ValueType>
-ValueType* HashTable<ValueType>::get(unsigned key) {
-    unsigned pos = key % tableSize();
+template <typename ValueType, typename KeyType>
+ValueType* HashTable<ValueType, KeyType>::get(const KeyType& key) {
+    unsigned home = hashOf(key);
+    unsigned pos = home;
     unsigned i = 1;
     while(hash_table[pos].stat != Status::Empty) {
         if(hash_table[pos].key == key && hash_table[pos].stat != Status::Deleted) {
             return &(hash_table[pos].value);
         }
-        quadraticProb(i, pos, key);
+        quadraticProb(i, pos, home);
     }
     return nullptr;
 }
 
-template<typename ValueType>
-const ValueType* HashTable<ValueType>::get(unsigned key) const {
-    unsigned pos = key % tableSize();
+template <typename ValueType, typename KeyType>
+const ValueType* HashTable<ValueType, KeyType>::get(const KeyType& key) const {
+    unsigned home = hashOf(key);
+    unsigned pos = home;
     unsigned i = 1;
     while(hash_table[pos].stat != Status::Empty) {
         if(hash_table[pos].key == key && hash_table[pos].stat != Status::Deleted) {
             return &(hash_table[pos].value);
         }
-        quadraticProb(i, pos, key);
+        quadraticProb(i, pos, home);
     }
     return nullptr;
 }
 
-template <typename ValueType>
-bool HashTable<ValueType>::update(unsigned key, const ValueType& newValue) {
+template <typename ValueType, typename KeyType>
+bool HashTable<ValueType, KeyType>::update(const KeyType& key, const ValueType& newValue) {
     if(get(key) == nullptr) {
         return false;
     }
@@ -109,39 +129,42 @@ bool HashTable<ValueType>::update(unsigned key, const ValueType& newValue) {
    
 }
 
-template <typename ValueType>
-bool HashTable<ValueType>::remove(unsigned key) {
-    unsigned pos = key % tableSize();
+template <typename ValueType, typename KeyType>
+bool HashTable<ValueType, KeyType>::remove(const KeyType& key) {
+    unsigned home = hashOf(key);
+    unsigned pos = home;
     unsigned i = 1;
 
     if(get(key) == nullptr) {
         return false;
     }
-    while(hash_table[pos].key != key) {
-        quadraticProb(i, pos, key);
+    while(!(hash_table[pos].key == key)) {
+        quadraticProb(i, pos, home);
     }
     hash_table[pos].stat = Status::Deleted;
     --num_element;
+    ++num_deleted;
     return true;
 }
 
-template <typename ValueType>
-unsigned HashTable<ValueType>::removeAllByValue(const ValueType& value) {
-    unsigned num_deleted = 0;
+template <typename ValueType, typename KeyType>
+unsigned HashTable<ValueType, KeyType>::removeAllByValue(const ValueType& value) {
+    unsigned num_removed = 0;
     for(unsigned i = 0; i < tableSize(); i++) {
         if(hash_table[i].value == value) {
             if(hash_table[i].stat == Status::Occupied) {
                 hash_table[i].stat = Status::Deleted;
-                ++num_deleted;
+                ++num_removed;
                 --num_element;
+                ++num_deleted;
             }
         }
     }
-    return num_deleted;
+    return num_removed;
 }
 
-template <typename ValueType>
-bool HashTable<ValueType>::operator==(const HashTable& rhs) const {
+template <typename ValueType, typename KeyType>
+bool HashTable<ValueType, KeyType>::operator==(const HashTable& rhs) const {
     unsigned size = 0;
     if(num_element != rhs.numElements()) {
         return false;
@@ -159,10 +182,11 @@ bool HashTable<ValueType>::operator==(const HashTable& rhs) const {
                 return false;
             }
 
-            unsigned pos = hash_table[i].key % rhs.tableSize();
+            unsigned home = rhs.hashOf(hash_table[i].key);
+            unsigned pos = home;
             unsigned iter = 1; 
-            while(rhs.hash_table[pos].key != hash_table[i].key) {
-                quadraticProb(iter, pos, hash_table[i].key);
+            while(!(rhs.hash_table[pos].key == hash_table[i].key)) {
+                rhs.quadraticProb(iter, pos, home);
             }
             if(!isSamePair(hash_table[i], rhs.hash_table[pos])) {
                 return false;
@@ -172,17 +196,17 @@ bool HashTable<ValueType>::operator==(const HashTable& rhs) const {
     return true;
 }
 
-template <typename ValueType>
-bool HashTable<ValueType>::operator!=(const HashTable& rhs) const {
+template <typename ValueType, typename KeyType>
+bool HashTable<ValueType, KeyType>::operator!=(const HashTable& rhs) const {
     if(*this == rhs) {
         return false;
     }
     return true;
 }
 
-template <typename ValueType>
-HashTable<ValueType> HashTable<ValueType>::operator+(const HashTable& rhs) const {
-    HashTable<ValueType> sum_hash(table_size);
+template <typename ValueType, typename KeyType>
+HashTable<ValueType, KeyType> HashTable<ValueType, KeyType>::operator+(const HashTable& rhs) const {
+    HashTable<ValueType, KeyType> sum_hash(table_size);
 
     for(unsigned i = 0; i < table_size; i++) {
         if(hash_table[i].stat == Status::Occupied) {
@@ -0,0 +1,156 @@
+#ifndef MULTI_QUEUE_HPP
+#define MULTI_QUEUE_HPP
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <thread>
+#include "hash_table.hpp"
+#include "priority_queue.hpp"
+
+/**
+ * Implementation of a concurrent relaxed priority queue
+ * ("MultiQueue") built from several PriorityQueue instances, each
+ * guarded by its own mutex.
+ *
+ * insert() puts the element into a random sub-queue.
+ * deleteMin() looks at the minimum of two random sub-queues and
+ * removes from the better one. Locks are only try-locked on these
+ * paths; a busy sub-queue is skipped in favour of another random
+ * pick instead of waited on, so threads rarely block each other and
+ * throughput scales with the number of sub-queues.
+ *
+ * The minimum removed is therefore approximate: it is the smallest
+ * element of some sub-queue, not necessarily of the whole structure.
+ * With numQueues sub-queues the expected rank of the removed element
+ * (0 being the true minimum) is O(numQueues), independently of the
+ * number of elements. A common choice is two sub-queues per thread.
+ *
+ * Each sub-queue publishes its current minimum key in an atomic so
+ * that the two-choice comparison does not need either lock.
+ *
+ * Keyed operations: in indexed mode, a concurrent hash index
+ * (HashTable shards, each with its own mutex) maps every key to the
+ * sub-queue that holds it, so keys are unique across the whole
+ * structure and decreaseKey()/increaseKey()/remove()/contains() are
+ * supported. Without the index, keys are only unique within a
+ * sub-queue and those functions return false.
+ *
+ * Locks are always taken sub-queue first, then index shards in
+ * increasing shard order, so the structure cannot deadlock.
+ */
+
+template <typename ValueType>
+class MultiQueue
+{
+public:
+    /**
+     * Creates a multi-queue of @numQueues sub-queues, each of which
+     * can have at most @maxSizePerQueue elements. If @indexed is true,
+     * the key index described above is maintained.
+     *
+     * Throws std::runtime_error if @numQueues or @maxSizePerQueue is 0.
+     */
+    MultiQueue(unsigned numQueues, unsigned maxSizePerQueue, bool indexed = false) {
+        if(numQueues == 0) {
+            throw std::runtime_error("Number of queues can't be zero");
+        }
+        if(maxSizePerQueue == 0) {
+            throw std::runtime_error("Max Size can't be zero");
+        }
+        num_queues = numQueues;
+        for(unsigned i = 0; i < numQueues; i++) {
+            queues.push_back(std::make_unique<SubQueue>(maxSizePerQueue));
+        }
+        if(indexed) {
+            for(unsigned i = 0; i < numQueues; i++) {
+                shards.push_back(std::make_unique<IndexShard>(nextPrime(maxSizePerQueue)));
+            }
+        }
+        num_element = 0;
+    }
+
+    MultiQueue(const MultiQueue& rhs) = delete;
+    MultiQueue& operator=(const MultiQueue& rhs) = delete;
+
+    /**
+     * Number of elements and sub-queues.
+     * numElements() is exact only when no other thread is modifying
+     * the multi-queue.
+     */
+    unsigned numElements() const {
+        return num_element.load(std::memory_order_relaxed);
+    }
+    unsigned numQueues() const {
+        return num_queues;
+    }
+    bool isIndexed() const {
+        return !shards.empty();
+    }
+
+    /**
+     * Inserts a key-value pair mapping @key to @value into a random
+     * sub-queue.
+     *
+     * Returns true if success.
+     * Returns false if no sub-queue has room for it, or, in indexed
+     * mode, if @key is already in the multi-queue.
+     */
+    bool insert(unsigned key, const ValueType& value);
+
+    /**
+     * Removes an approximately smallest element (see above) and
+     * returns it, with its value moved out.
+     *
+     * Returns std::nullopt if every sub-queue was seen empty.
+     */
+    std::optional<KeyValuePair<ValueType>> extractMin();
+    bool deleteMin();
+
+    /**
+     * Indexed mode only: same as the PriorityQueue functions of the
+     * same name, applied to whichever sub-queue holds @key.
+     *
+     * Return false if the multi-queue is not indexed, plus in every
+     * case where the PriorityQueue function would.
+     */
+    bool decreaseKey(unsigned key, unsigned change);
+    bool increaseKey(unsigned key, unsigned change);
+    bool remove(unsigned key);
+    bool contains(unsigned key);
+
+private:
+    static const unsigned long long EMPTY = ~0ULL;
+
+    struct alignas(64) SubQueue{
+        std::mutex lock;
+        PriorityQueue<ValueType> pq;
+        std::atomic<unsigned long long> top;
+
+        explicit SubQueue(unsigned maxSize) : pq(maxSize), top(EMPTY) {}
+    };
+
+    struct alignas(64) IndexShard{
+        std::mutex lock;
+        HashTable<unsigned> ht;
+
+        explicit IndexShard(unsigned tableSize) : ht(tableSize) {}
+    };
+
+    std::vector<std::unique_ptr<SubQueue>> queues;
+    std::vector<std::unique_ptr<IndexShard>> shards;
+    unsigned num_queues;
+    std::atomic<unsigned> num_element;
+
+    unsigned randomQueue();
+    void publishTop(SubQueue& queue);
+    unsigned shardOf(unsigned key) const;
+    bool changeKey(unsigned key, unsigned change, bool decrease);
+};
+
+#include "multi_queue.inl"
+#endif  // MULTI_QUEUE_HPP
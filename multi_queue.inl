@@ -0,0 +1,238 @@
+template <typename ValueType>
+unsigned MultiQueue<ValueType>::randomQueue() {
+    thread_local std::minstd_rand rng(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return rng() % num_queues;
+}
+
+template <typename ValueType>
+void MultiQueue<ValueType>::publishTop(SubQueue& queue) {
+    const unsigned* min = queue.pq.getMinKey();
+    queue.top.store(min == nullptr ? EMPTY : *min, std::memory_order_relaxed);
+}
+
+template <typename ValueType>
+unsigned MultiQueue<ValueType>::shardOf(unsigned key) const {
+    return key % shards.size();
+}
+
+template <typename ValueType>
+bool MultiQueue<ValueType>::insert(unsigned key, const ValueType& value) {
+    bool duplicate = false;
+
+    // caller holds the lock of sub-queue i
+    auto insertInto = [&](unsigned i) {
+        SubQueue& queue = *queues[i];
+        if(isIndexed()) {
+            IndexShard& shard = *shards[shardOf(key)];
+            std::lock_guard<std::mutex> shard_guard(shard.lock);
+            if(shard.ht.get(key) != nullptr) {
+                duplicate = true;
+                return false;
+            }
+            if(!queue.pq.insert(key, value)) {
+                return false;
+            }
+            shard.ht.insert(key, i);
+        }else if(!queue.pq.insert(key, value)) {
+            return false;
+        }
+        publishTop(queue);
+        ++num_element;
+        return true;
+    };
+
+    for(unsigned attempt = 0; attempt < 2 * num_queues; attempt++) {
+        unsigned i = randomQueue();
+        std::unique_lock<std::mutex> guard(queues[i]->lock, std::try_to_lock);
+        if(!guard.owns_lock()) {
+            continue;
+        }
+        if(insertInto(i)) {
+            return true;
+        }
+        if(duplicate) {
+            return false;
+        }
+    }
+
+    // the random picks were busy or full, so visit every sub-queue once
+    unsigned start = randomQueue();
+    for(unsigned n = 0; n < num_queues; n++) {
+        unsigned i = (start + n) % num_queues;
+        std::lock_guard<std::mutex> guard(queues[i]->lock);
+        if(insertInto(i)) {
+            return true;
+        }
+        if(duplicate) {
+            return false;
+        }
+    }
+    return false;
+}
+
+template <typename ValueType>
+std::optional<KeyValuePair<ValueType>> MultiQueue<ValueType>::extractMin() {
+    // caller holds the lock of sub-queue i
+    auto extractFrom = [&](unsigned i) {
+        SubQueue& queue = *queues[i];
+        std::optional<KeyValuePair<ValueType>> min = queue.pq.extractMin();
+        if(!min) {
+            return min;
+        }
+        publishTop(queue);
+        if(isIndexed()) {
+            IndexShard& shard = *shards[shardOf(min->key)];
+            std::lock_guard<std::mutex> shard_guard(shard.lock);
+            shard.ht.remove(min->key);
+        }
+        --num_element;
+        return min;
+    };
+
+    for(unsigned attempt = 0; attempt < 2 * num_queues; attempt++) {
+        unsigned i = randomQueue();
+        unsigned j = randomQueue();
+        unsigned long long top_i = queues[i]->top.load(std::memory_order_relaxed);
+        unsigned long long top_j = queues[j]->top.load(std::memory_order_relaxed);
+        if(top_j < top_i) {
+            i = j;
+            top_i = top_j;
+        }
+        if(top_i == EMPTY) {
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(queues[i]->lock, std::try_to_lock);
+        if(!guard.owns_lock()) {
+            continue;
+        }
+        std::optional<KeyValuePair<ValueType>> min = extractFrom(i);
+        if(min) {
+            return min;
+        }
+    }
+
+    // the random picks kept coming up empty or busy, so visit every
+    // sub-queue that still looks non-empty
+    for(unsigned i = 0; i < num_queues; i++) {
+        if(queues[i]->top.load(std::memory_order_relaxed) == EMPTY) {
+            continue;
+        }
+        std::lock_guard<std::mutex> guard(queues[i]->lock);
+        std::optional<KeyValuePair<ValueType>> min = extractFrom(i);
+        if(min) {
+            return min;
+        }
+    }
+    return std::nullopt;
+}
+
+template <typename ValueType>
+bool MultiQueue<ValueType>::deleteMin() {
+    return extractMin().has_value();
+}
+
+template <typename ValueType>
+bool MultiQueue<ValueType>::changeKey(unsigned key, unsigned change, bool decrease) {
+    if(!isIndexed() || change == 0) {
+        return false;
+    }
+    unsigned new_key = decrease ? key - change : key + change;
+    IndexShard& old_shard = *shards[shardOf(key)];
+    IndexShard& new_shard = *shards[shardOf(new_key)];
+
+    while(true) {
+        unsigned i = 0;
+        {
+            std::lock_guard<std::mutex> shard_guard(old_shard.lock);
+            const unsigned* where = old_shard.ht.get(key);
+            if(where == nullptr) {
+                return false;
+            }
+            i = *where;
+        }
+
+        SubQueue& queue = *queues[i];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        IndexShard* first = shardOf(key) < shardOf(new_key) ? &old_shard : &new_shard;
+        IndexShard* second = first == &old_shard ? &new_shard : &old_shard;
+        std::unique_lock<std::mutex> first_guard(first->lock);
+        std::unique_lock<std::mutex> second_guard;
+        if(second != first) {
+            second_guard = std::unique_lock<std::mutex>(second->lock);
+        }
+
+        const unsigned* where = old_shard.ht.get(key);
+        if(where == nullptr) {
+            return false;
+        }
+        if(*where != i) {   // popped and reinserted elsewhere meanwhile
+            continue;
+        }
+        if(new_shard.ht.get(new_key) != nullptr) {
+            return false;
+        }
+        bool changed = decrease ? queue.pq.decreaseKey(key, change) : queue.pq.increaseKey(key, change);
+        if(changed) {
+            old_shard.ht.remove(key);
+            new_shard.ht.insert(new_key, i);
+            publishTop(queue);
+        }
+        return changed;
+    }
+}
+
+template <typename ValueType>
+bool MultiQueue<ValueType>::decreaseKey(unsigned key, unsigned change) {
+    return changeKey(key, change, true);
+}
+
+template <typename ValueType>
+bool MultiQueue<ValueType>::increaseKey(unsigned key, unsigned change) {
+    return changeKey(key, change, false);
+}
+
+template <typename ValueType>
+bool MultiQueue<ValueType>::remove(unsigned key) {
+    if(!isIndexed()) {
+        return false;
+    }
+    IndexShard& shard = *shards[shardOf(key)];
+
+    while(true) {
+        unsigned i = 0;
+        {
+            std::lock_guard<std::mutex> shard_guard(shard.lock);
+            const unsigned* where = shard.ht.get(key);
+            if(where == nullptr) {
+                return false;
+            }
+            i = *where;
+        }
+
+        SubQueue& queue = *queues[i];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        std::lock_guard<std::mutex> shard_guard(shard.lock);
+        const unsigned* where = shard.ht.get(key);
+        if(where == nullptr) {
+            return false;
+        }
+        if(*where != i) {   // popped and reinserted elsewhere meanwhile
+            continue;
+        }
+        queue.pq.remove(key);
+        shard.ht.remove(key);
+        publishTop(queue);
+        --num_element;
+        return true;
+    }
+}
+
+template <typename ValueType>
+bool MultiQueue<ValueType>::contains(unsigned key) {
+    if(!isIndexed()) {
+        return false;
+    }
+    IndexShard& shard = *shards[shardOf(key)];
+    std::lock_guard<std::mutex> shard_guard(shard.lock);
+    return shard.ht.get(key) != nullptr;
+}
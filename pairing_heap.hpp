@@ -0,0 +1,200 @@
+#ifndef PAIRING_HEAP_HPP
+#define PAIRING_HEAP_HPP
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "hash_table.hpp"
+#include "priority_queue.hpp"
+
+/**
+ * Implementation of a meldable priority queue (pairing heap) that
+ * supports the same extended API as PriorityQueue, plus meld().
+ *
+ * The heap is a tree of nodes in which every node's key is smaller
+ * than its children's. Each node points to its leftmost child, its
+ * right sibling, and "prev", which is its left sibling, or its parent
+ * if it is the leftmost child. Two trees are linked in constant time
+ * by making the root with the larger key the leftmost child of the
+ * other; deleteMin() merges the root's children pairwise left to
+ * right and then links the pairs right to left (two-pass pairing).
+ *
+ * Run times: insert(), getMinKey(), getMinValue() and the heap part of
+ * meld() are constant; deleteMin(), remove(), increaseKey() are
+ * amortized logarithmic; decreaseKey() is amortized o(log n).
+ *
+ * As with PriorityQueue, a hash table maps each key to its node so
+ * that the keyed operations run in "constant time" + the above. This
+ * index is the only part of meld() that is not constant time: the
+ * smaller heap's keys are moved into the larger heap's index, so
+ * meld() costs O(min(n, m)) hash operations.
+ */
+
+template <typename ValueType>
+struct PairingNode{
+    unsigned key;
+    ValueType value;
+    PairingNode* child = nullptr;
+    PairingNode* sibling = nullptr;
+    PairingNode* prev = nullptr;
+};
+
+template <typename ValueType>
+class PairingHeap
+{
+public:
+    /**
+     * Creates an empty pairing heap. There is no maximum size;
+     * @sizeHint only sizes the initial hash table.
+     */
+    explicit PairingHeap(unsigned sizeHint = 11) : ht(HashTable<PairingNode<ValueType>*>(nextPrime(sizeHint))) {
+        root = nullptr;
+        num_element = 0;
+    }
+
+    ~PairingHeap() {
+        clear();
+    }
+
+    /**
+     * Makes this pairing heap contain exactly the same elements as
+     * @rhs, with the same tree shape.
+     */
+    PairingHeap(const PairingHeap& rhs) : ht(HashTable<PairingNode<ValueType>*>(nextPrime(rhs.num_element*2+1))) {
+        root = copyTree(rhs.root);
+        num_element = rhs.num_element;
+    }
+    PairingHeap& operator=(const PairingHeap& rhs) {
+        if(this != &rhs) {
+            clear();
+            ht = HashTable<PairingNode<ValueType>*>(nextPrime(rhs.num_element*2+1));
+            root = copyTree(rhs.root);
+            num_element = rhs.num_element;
+        }
+        return *this;
+    }
+
+    /**
+     * Takes the nodes of @rhs and gives them to "this" object.
+     * After this, @rhs should be in a "moved from" state.
+     */
+    PairingHeap(PairingHeap&& rhs) noexcept : ht(std::move(rhs.ht)) {
+        root = rhs.root;
+        num_element = rhs.num_element;
+        rhs.root = nullptr;
+        rhs.num_element = 0;
+    }
+    PairingHeap& operator=(PairingHeap&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            ht = std::move(rhs.ht);
+            root = rhs.root;
+            num_element = rhs.num_element;
+            rhs.root = nullptr;
+            rhs.num_element = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * Must run in constant time.
+     */
+    unsigned numElements() const {
+        return num_element;
+    }
+
+    /**
+     * Inserts a key-value pair mapping @key to @value.
+     *
+     * Returns true if success.
+     * Returns false if @key is already in the pairing heap
+     * (in which case, the insertion is not performed).
+     */
+    bool insert(unsigned key, const ValueType& value);
+
+    /**
+     * Returns key/value of the smallest element or null pointer if empty.
+     *
+     * The pointer may be invalidated if the pairing heap is modified.
+     */
+    const unsigned* getMinKey() const;
+    const ValueType* getMinValue() const;
+
+    /**
+     * Removes the root of the pairing heap.
+     *
+     * Returns true if success.
+     * Returns false if pairing heap is empty, i.e. nothing to delete.
+     */
+    bool deleteMin();
+
+    /**
+     * Removes the root and returns it, with its value moved out.
+     *
+     * Returns std::nullopt if pairing heap is empty.
+     */
+    std::optional<KeyValuePair<ValueType>> extractMin();
+
+    /**
+     * Returns address of the value that @key is mapped to.
+     *
+     * Returns null pointer if @key is not in the pairing heap.
+     */
+    ValueType* get(unsigned key);
+    const ValueType* get(unsigned key) const;
+
+    /**
+     * Subtracts/adds @change from/to the key of the element that
+     * has key @key.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @key not found.
+     * - If the change would lead to a duplicate key.
+     *
+     * The function does not do anything about overflow/underflow.
+     */
+    bool decreaseKey(unsigned key, unsigned change);
+    bool increaseKey(unsigned key, unsigned change);
+
+    /**
+     * Removes element that has key @key.
+     *
+     * Returns true if success.
+     * Returns false if @key not found.
+     */
+    bool remove(unsigned key);
+
+    /**
+     * Moves every element of @rhs into this pairing heap, leaving
+     * @rhs empty. As with HashTable::operator+, if a key is in both
+     * heaps, the element of this heap is kept and the one of @rhs is
+     * dropped.
+     */
+    void meld(PairingHeap& rhs);
+
+    /**
+     * Returns a newly constructed pairing heap that contains the
+     * elements of this pairing heap and those of @rhs whose keys are
+     * not in this one.
+     */
+    PairingHeap operator+(const PairingHeap& rhs) const;
+
+private:
+    PairingNode<ValueType>* root;
+    HashTable<PairingNode<ValueType>*> ht;
+    unsigned num_element;
+    std::vector<PairingNode<ValueType>*> scratch;
+
+    static PairingNode<ValueType>* link(PairingNode<ValueType>* a, PairingNode<ValueType>* b);
+    static void cut(PairingNode<ValueType>* node);
+    PairingNode<ValueType>* mergePairs(PairingNode<ValueType>* first);
+    void detach(PairingNode<ValueType>* node);
+    PairingNode<ValueType>* copyTree(const PairingNode<ValueType>* source);
+    void clear();
+};
+
+#include "pairing_heap.inl"
+#endif  // PAIRING_HEAP_HPP
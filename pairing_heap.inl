@@ -0,0 +1,306 @@
+template <typename ValueType>
+PairingNode<ValueType>* PairingHeap<ValueType>::link(PairingNode<ValueType>* a, PairingNode<ValueType>* b) {
+    if(a == nullptr) {
+        return b;
+    }
+    if(b == nullptr) {
+        return a;
+    }
+    if(b->key < a->key) {
+        std::swap(a, b);
+    }
+    // b becomes the leftmost child of a
+    b->prev = a;
+    b->sibling = a->child;
+    if(a->child != nullptr) {
+        a->child->prev = b;
+    }
+    a->child = b;
+    return a;
+}
+
+template <typename ValueType>
+void PairingHeap<ValueType>::cut(PairingNode<ValueType>* node) {
+    if(node->prev->child == node) {
+        node->prev->child = node->sibling;
+    }else {
+        node->prev->sibling = node->sibling;
+    }
+    if(node->sibling != nullptr) {
+        node->sibling->prev = node->prev;
+    }
+    node->prev = nullptr;
+    node->sibling = nullptr;
+}
+
+template <typename ValueType>
+PairingNode<ValueType>* PairingHeap<ValueType>::mergePairs(PairingNode<ValueType>* first) {
+    if(first == nullptr) {
+        return nullptr;
+    }
+
+    scratch.clear();
+    while(first != nullptr) {
+        PairingNode<ValueType>* next = first->sibling;
+        first->prev = nullptr;
+        first->sibling = nullptr;
+        scratch.push_back(first);
+        first = next;
+    }
+
+    // first pass: link pairs left to right
+    unsigned num_trees = 0;
+    for(unsigned i = 0; i + 1 < scratch.size(); i += 2) {
+        scratch[num_trees++] = link(scratch[i], scratch[i+1]);
+    }
+    if(scratch.size() % 2 == 1) {
+        scratch[num_trees++] = scratch.back();
+    }
+
+    // second pass: link the results right to left
+    PairingNode<ValueType>* merged = scratch[num_trees-1];
+    for(unsigned i = num_trees - 1; i > 0; i--) {
+        merged = link(scratch[i-1], merged);
+    }
+    return merged;
+}
+
+template <typename ValueType>
+void PairingHeap<ValueType>::detach(PairingNode<ValueType>* node) {
+    if(node == root) {
+        root = mergePairs(node->child);
+    }else {
+        cut(node);
+        root = link(root, mergePairs(node->child));
+    }
+    node->child = nullptr;
+}
+
+template <typename ValueType>
+PairingNode<ValueType>* PairingHeap<ValueType>::copyTree(const PairingNode<ValueType>* source) {
+    if(source == nullptr) {
+        return nullptr;
+    }
+
+    // iterative, since a pairing heap can be a single long sibling chain
+    std::vector<std::pair<const PairingNode<ValueType>*, PairingNode<ValueType>*>> stack;
+    PairingNode<ValueType>* copy = new PairingNode<ValueType>{source->key, source->value};
+    ht.insert(copy->key, copy);
+    stack.push_back({source, copy});
+    while(!stack.empty()) {
+        const PairingNode<ValueType>* from = stack.back().first;
+        PairingNode<ValueType>* to = stack.back().second;
+        stack.pop_back();
+        if(from->child != nullptr) {
+            to->child = new PairingNode<ValueType>{from->child->key, from->child->value};
+            to->child->prev = to;
+            ht.insert(to->child->key, to->child);
+            stack.push_back({from->child, to->child});
+        }
+        if(from->sibling != nullptr) {
+            to->sibling = new PairingNode<ValueType>{from->sibling->key, from->sibling->value};
+            to->sibling->prev = to;
+            ht.insert(to->sibling->key, to->sibling);
+            stack.push_back({from->sibling, to->sibling});
+        }
+    }
+    return copy;
+}
+
+template <typename ValueType>
+void PairingHeap<ValueType>::clear() {
+    if(root == nullptr) {
+        return;
+    }
+    scratch.clear();
+    scratch.push_back(root);
+    while(!scratch.empty()) {
+        PairingNode<ValueType>* node = scratch.back();
+        scratch.pop_back();
+        if(node->child != nullptr) {
+            scratch.push_back(node->child);
+        }
+        if(node->sibling != nullptr) {
+            scratch.push_back(node->sibling);
+        }
+        delete node;
+    }
+    root = nullptr;
+    num_element = 0;
+}
+
+template <typename ValueType>
+bool PairingHeap<ValueType>::insert(unsigned key, const ValueType& value) {
+    if(ht.get(key) != nullptr) {
+        return false;
+    }
+    PairingNode<ValueType>* node = new PairingNode<ValueType>{key, value};
+    ht.insert(key, node);
+    root = link(root, node);
+    ++num_element;
+    return true;
+}
+
+template <typename ValueType>
+const unsigned* PairingHeap<ValueType>::getMinKey() const {
+    if(root == nullptr) {
+        return nullptr;
+    }
+    return &(root->key);
+}
+
+template <typename ValueType>
+const ValueType* PairingHeap<ValueType>::getMinValue() const {
+    if(root == nullptr) {
+        return nullptr;
+    }
+    return &(root->value);
+}
+
+template <typename ValueType>
+bool PairingHeap<ValueType>::deleteMin() {
+    return extractMin().has_value();
+}
+
+template <typename ValueType>
+std::optional<KeyValuePair<ValueType>> PairingHeap<ValueType>::extractMin() {
+    if(root == nullptr) {
+        return std::nullopt;
+    }
+    PairingNode<ValueType>* min = root;
+    KeyValuePair<ValueType> pair = {min->key, std::move(min->value)};
+    root = mergePairs(min->child);
+    ht.remove(min->key);
+    delete min;
+    --num_element;
+    return pair;
+}
+
+template <typename ValueType>
+ValueType* PairingHeap<ValueType>::get(unsigned key) {
+    PairingNode<ValueType>** node = ht.get(key);
+    if(node == nullptr) {
+        return nullptr;
+    }
+    return &((*node)->value);
+}
+
+template <typename ValueType>
+const ValueType* PairingHeap<ValueType>::get(unsigned key) const {
+    PairingNode<ValueType>* const* node = ht.get(key);
+    if(node == nullptr) {
+        return nullptr;
+    }
+    return &((*node)->value);
+}
+
+template <typename ValueType>
+bool PairingHeap<ValueType>::decreaseKey(unsigned key, unsigned change) {
+    if(change == 0 || ht.get(key) == nullptr || ht.get(key - change) != nullptr) {
+        return false;
+    }
+
+    PairingNode<ValueType>* node = *(ht.get(key));
+    ht.remove(key);
+    node->key -= change;
+    ht.insert(node->key, node);
+    if(node != root) {   // its subtree stays heap-ordered, so move it whole
+        cut(node);
+        root = link(root, node);
+    }
+    return true;
+}
+
+template <typename ValueType>
+bool PairingHeap<ValueType>::increaseKey(unsigned key, unsigned change) {
+    if(change == 0 || ht.get(key) == nullptr || ht.get(key + change) != nullptr) {
+        return false;
+    }
+
+    PairingNode<ValueType>* node = *(ht.get(key));
+    detach(node);
+    ht.remove(key);
+    node->key += change;
+    ht.insert(node->key, node);
+    root = link(root, node);
+    return true;
+}
+
+template <typename ValueType>
+bool PairingHeap<ValueType>::remove(unsigned key) {
+    if(ht.get(key) == nullptr) {
+        return false;
+    }
+
+    PairingNode<ValueType>* node = *(ht.get(key));
+    detach(node);
+    ht.remove(key);
+    delete node;
+    --num_element;
+    return true;
+}
+
+template <typename ValueType>
+void PairingHeap<ValueType>::meld(PairingHeap& rhs) {
+    if(&rhs == this || rhs.root == nullptr) {
+        return;
+    }
+
+    // only the smaller heap's keys go through a hash table
+    PairingHeap& small = rhs.num_element <= num_element ? rhs : *this;
+    PairingHeap& large = &small == this ? rhs : *this;
+
+    std::vector<PairingNode<ValueType>*> nodes;
+    if(small.root != nullptr) {
+        nodes.push_back(small.root);
+    }
+    for(unsigned i = 0; i < nodes.size(); i++) {
+        if(nodes[i]->child != nullptr) {
+            nodes.push_back(nodes[i]->child);
+        }
+        if(nodes[i]->sibling != nullptr) {
+            nodes.push_back(nodes[i]->sibling);
+        }
+    }
+
+    // on a duplicate key, drop the element that came from rhs
+    for(unsigned i = 0; i < nodes.size(); i++) {
+        PairingNode<ValueType>** existing = large.ht.get(nodes[i]->key);
+        if(existing == nullptr) {
+            continue;
+        }
+        PairingNode<ValueType>* loser = &small == &rhs ? nodes[i] : *existing;
+        PairingHeap& owner = &small == &rhs ? small : large;
+        owner.detach(loser);
+        owner.ht.remove(loser->key);
+        --owner.num_element;
+        if(loser == nodes[i]) {
+            nodes[i] = nullptr;
+        }
+        delete loser;
+    }
+    for(unsigned i = 0; i < nodes.size(); i++) {
+        if(nodes[i] != nullptr) {
+            large.ht.insert(nodes[i]->key, nodes[i]);
+        }
+    }
+
+    large.root = link(large.root, small.root);
+    large.num_element += small.num_element;
+    small.root = nullptr;
+    small.num_element = 0;
+    small.ht = HashTable<PairingNode<ValueType>*>(11);
+    if(&large != this) {
+        std::swap(root, rhs.root);
+        std::swap(num_element, rhs.num_element);
+        std::swap(ht, rhs.ht);
+    }
+}
+
+template <typename ValueType>
+PairingHeap<ValueType> PairingHeap<ValueType>::operator+(const PairingHeap& rhs) const {
+    PairingHeap<ValueType> sum_heap(*this);
+    PairingHeap<ValueType> rhs_copy(rhs);
+    sum_heap.meld(rhs_copy);
+    return sum_heap;
+}
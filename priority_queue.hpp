@@ -3,6 +3,14 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+#include <functional>
+#include <string>
+#include <type_traits>
 #include "hash_table.hpp"
 
 /**
@@ -25,30 +33,82 @@
  * The priority queue's underlying implementation is
  * required to be a binary min heap and the hash table
  * that you implement in the first part of this assignment.
+ *
+ * Keys are unsigned and ordered by std::less by default. KeyType
+ * and Compare replace them for other orderings, e.g.
+ * PriorityQueue<V, unsigned, std::greater<unsigned>> is a max heap,
+ * and a struct holding (priority, deadline) with its own operator<
+ * gives composite priorities without packing them into one integer.
+ * "Smallest" below means first according to Compare. KeyType needs
+ * operator== and a hash (see KeyHash in hash_table.hpp). The default
+ * std::less<unsigned> is an empty class whose call inlines to the
+ * built-in <, so the default instantiation compiles to the same code
+ * as a hard-coded comparison.
  */
 
-template <typename ValueType>
+template <typename ValueType, typename KeyType = unsigned>
 struct KeyValuePair{
-    unsigned key;
+    KeyType key;
     ValueType value;
 };
 
-template <typename ValueType>
+const unsigned PQ_CHECKPOINT_MAGIC = 0x50514331;   // "PQC1" read as a little-endian word
+const unsigned PQ_CHECKPOINT_VERSION = 1;
+
+/**
+ * Binary encoding of one key or value, used by PriorityQueue::save()
+ * and load() when the elements are not trivially copyable. Trivially
+ * copyable types are written as raw bytes and std::string as its
+ * length followed by its characters; other types need their own
+ * overloads of both functions.
+ *
+ * readBinary() returns false on a short read.
+ */
+template <typename T>
+typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+writeBinary(std::ostream& os, const T& data) {
+    os.write(reinterpret_cast<const char*>(&data), sizeof(T));
+}
+
+template <typename T>
+typename std::enable_if<std::is_trivially_copyable<T>::value, bool>::type
+readBinary(std::istream& is, T& data) {
+    return (bool)is.read(reinterpret_cast<char*>(&data), sizeof(T));
+}
+
+inline void writeBinary(std::ostream& os, const std::string& data) {
+    writeBinary(os, (unsigned long long)data.size());
+    os.write(data.data(), data.size());
+}
+
+inline bool readBinary(std::istream& is, std::string& data) {
+    unsigned long long size = 0;
+    if(!readBinary(is, size)) {
+        return false;
+    }
+    data.resize(size);
+    return (bool)is.read(&data[0], size);
+}
+
+template <typename ValueType, typename KeyType = unsigned, typename Compare = std::less<KeyType>>
 class PriorityQueue
 {
 public:
     /**
-     * Creates a priority queue that can have at most @maxSize elements.
+     * Creates a priority queue that can have at most @maxSize elements,
+     * ordered by @compare.
      *
      * Throws std::runtime_error if @maxSize is 0.
      */
-    explicit PriorityQueue(unsigned maxSize) : ht(HashTable<unsigned>(nextPrime(maxSize))) {
+    explicit PriorityQueue(unsigned maxSize, const Compare& compare = Compare())
+        : ht(HashTable<unsigned, KeyType>(nextPrime(maxSize))), compare(compare) {
         if(maxSize == 0) {
             throw std::runtime_error("Max Size can't be zero");
         }
-        binary_heap = std::make_unique<KeyValuePair<ValueType>[]>(maxSize+1);
+        binary_heap = std::make_unique<KeyValuePair<ValueType, KeyType>[]>(maxSize+1);
         max_size = maxSize;
         num_element = 0;
+        lazy_updates = false;
     }
     
     ~PriorityQueue() {}
@@ -57,26 +117,32 @@ public:
      * Makes the underlying implementation details (including the max size) look
      * exactly the same as that of @rhs.
      */
-    PriorityQueue(const PriorityQueue& rhs) : ht(HashTable<unsigned>(nextPrime(rhs.max_size))) {
+    PriorityQueue(const PriorityQueue& rhs)
+        : ht(HashTable<unsigned, KeyType>(nextPrime(rhs.max_size))), compare(rhs.compare) {
         max_size = rhs.max_size;
         num_element = rhs.num_element;
-        binary_heap = std::make_unique<KeyValuePair<ValueType>[]>(max_size+1);
+        binary_heap = std::make_unique<KeyValuePair<ValueType, KeyType>[]>(max_size+1);
         for(unsigned i = 1; i <= rhs.num_element; i++) {
             binary_heap[i].key = rhs.binary_heap[i].key;
             binary_heap[i].value = rhs.binary_heap[i].value;
             ht.insert(rhs.binary_heap[i].key, i);
         }
+        pending_updates = rhs.pending_updates;
+        lazy_updates = rhs.lazy_updates;
     }
     PriorityQueue& operator=(const PriorityQueue& rhs) {
+        compare = rhs.compare;
         max_size = rhs.max_size;
         num_element = rhs.num_element;
-        ht = HashTable<unsigned>(nextPrime(rhs.max_size));
-        binary_heap = std::make_unique<KeyValuePair<ValueType>[]>(max_size+1);
+        ht = HashTable<unsigned, KeyType>(nextPrime(rhs.max_size));
+        binary_heap = std::make_unique<KeyValuePair<ValueType, KeyType>[]>(max_size+1);
         for(unsigned i = 1; i <= rhs.num_element; i++) {
             binary_heap[i].key = rhs.binary_heap[i].key;
             binary_heap[i].value = rhs.binary_heap[i].value;
             ht.insert(rhs.binary_heap[i].key, i);
         }
+        pending_updates = rhs.pending_updates;
+        lazy_updates = rhs.lazy_updates;
         return *this;
     }
 
@@ -85,19 +151,24 @@ public:
      * and gives them to "this" object.
      * After this, @rhs should be in a "moved from" state.
      */
-    PriorityQueue(PriorityQueue&& rhs) noexcept : ht(std::move(rhs.ht)){
+    PriorityQueue(PriorityQueue&& rhs) noexcept : ht(std::move(rhs.ht)), compare(std::move(rhs.compare)) {
         max_size = rhs.max_size;
         num_element = rhs.num_element;
         binary_heap = std::move(rhs.binary_heap);
+        pending_updates = std::move(rhs.pending_updates);
+        lazy_updates = rhs.lazy_updates;
         rhs.binary_heap = nullptr;
         rhs.num_element = 0;
     }
 
     PriorityQueue& operator=(PriorityQueue&& rhs) noexcept {
+        compare = std::move(rhs.compare);
         max_size = rhs.max_size;
         num_element = rhs.num_element;
         binary_heap = std::move(rhs.binary_heap);
         ht = std::move(rhs.ht);
+        pending_updates = std::move(rhs.pending_updates);
+        lazy_updates = rhs.lazy_updates;
         rhs.binary_heap = nullptr;
         rhs.num_element = 0;
         return *this;
@@ -116,12 +187,14 @@ public:
     /**
      * Print the underlying heap level-by-level.
      * See prog_hw4.pdf for how exactly this should look.
+     * Throws std::runtime_error if lazy updates are pending.
      */
     friend std::ostream& operator<<(
         std::ostream& os,
-        const PriorityQueue<ValueType>& pq)
+        const PriorityQueue& pq)
     {
         // TODO: Implement this method.
+        pq.requireNoPendingUpdates();
         unsigned i_double = 1;
         for(unsigned i = 1; i <= pq.num_element; i++) {
             if(i == i_double * 2) {
@@ -146,7 +219,7 @@ public:
      * (In either of these cases, the insertion is not performed.)
      * In this case, must run in "constant time".
      */
-    bool insert(unsigned key, const ValueType& value);
+    bool insert(const KeyType& key, const ValueType& value);
 
     /**
      * Returns key of the smallest element in the priority queue
@@ -155,8 +228,13 @@ public:
      * This function must run in constant time.
      *
      * The pointer may be invalidated if the priority queue is modified.
+     *
+     * In lazy update mode (see updateKeys()) the non-const version
+     * applies the pending updates first; the const version cannot, so
+     * it throws std::runtime_error while updates are pending.
      */
-    const unsigned* getMinKey() const;
+    const KeyType* getMinKey();
+    const KeyType* getMinKey() const;
 
     /**
      * Returns value of the smallest element in the priority queue
@@ -165,7 +243,10 @@ public:
      * This function must run in constant time.
      *
      * The pointer may be invalidated if the priority queue is modified.
+     *
+     * Same lazy update rule as getMinKey().
      */
+    const ValueType* getMinValue();
     const ValueType* getMinValue() const;
 
     /**
@@ -178,19 +259,77 @@ public:
      */
     bool deleteMin();
 
+    /**
+     * Removes the root of the priority queue and returns it,
+     * with its value moved out rather than copied.
+     *
+     * This function must run in logarithmic time.
+     *
+     * Returns std::nullopt if priority queue is empty.
+     */
+    std::optional<KeyValuePair<ValueType, KeyType>> extractMin();
+
+    /**
+     * Removes the (up to) @k smallest elements and appends them to
+     * @out in increasing key order, values moved out.
+     *
+     * The k smallest elements always form a subtree hanging off the
+     * root, so they are selected by walking that subtree, and the
+     * holes they leave are refilled from the tail of the heap and
+     * sifted down bottom-up in a single pass (as in heapify)
+     * instead of k separate deleteMin() calls.
+     *
+     * This function must run in O(k log n) time.
+     *
+     * Returns the number of elements removed.
+     */
+    unsigned popBatch(unsigned k, std::vector<KeyValuePair<ValueType, KeyType>>& out);
+
+    /**
+     * Removes the root and inserts a key-value pair mapping @key to
+     * @value with a single sift-down, i.e. deleteMin() followed by
+     * insert() without the intermediate percolate up.
+     *
+     * This function must run in logarithmic time.
+     *
+     * Returns the removed root.
+     * Returns std::nullopt if priority queue is empty or if @key
+     * is already in the priority queue and is not the root's key.
+     * (In either of these cases, nothing is performed.)
+     */
+    std::optional<KeyValuePair<ValueType, KeyType>> replaceMin(const KeyType& key, const ValueType& value);
+
     /**
      * Returns address of the value that @key is mapped to in the priority queue.
      *
      * These functions must run in "constant time".
      *
      * Returns null pointer if @key is not in the table.
+     *
+     * Same lazy update rule as getMinKey().
      */
-    ValueType* get(unsigned key);
-    const ValueType* get(unsigned key) const;
+    ValueType* get(const KeyType& key);
+    const ValueType* get(const KeyType& key) const;
+
+    /**
+     * Replaces the key of the element that has key @key with @newKey
+     * and moves the element up or down accordingly.
+     *
+     * This function must run in "constant time" + logarithmic time.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @newKey is equal to @key.
+     * - @key not found.
+     * - If @newKey is already in the priority queue.
+     */
+    bool changeKey(const KeyType& key, const KeyType& newKey);
 
     /**
      * Subtracts/adds @change from/to the key of
-     * the element that has key @key.
+     * the element that has key @key, i.e. changeKey() for keys that
+     * support - and +. With a max heap, decreaseKey() still makes the
+     * key smaller and therefore moves the element down.
      *
      * These functions must run in "constant time" + logarithmic time.
      * This means you must use the required hash table to find the
@@ -206,8 +345,8 @@ public:
      * For example, an operation like decreaseKey(2, 10)
      * has an undefined effect.
      */
-    bool decreaseKey(unsigned key, unsigned change);
-    bool increaseKey(unsigned key, unsigned change);
+    bool decreaseKey(const KeyType& key, const KeyType& change);
+    bool increaseKey(const KeyType& key, const KeyType& change);
 
     /**
      * Removes element that has key @key.
@@ -219,19 +358,119 @@ public:
      * Returns true if success.
      * Returns false if @key not found.
      */
-    bool remove(unsigned key);
+    bool remove(const KeyType& key);
+
+    /**
+     * Inserts each element of @rhs whose key is not already in this
+     * priority queue. As with HashTable::operator+, on a duplicate key
+     * the element of this priority queue is kept.
+     *
+     * When @rhs is large enough, its elements are appended to the
+     * underlying array and the heap is rebuilt bottom-up (heapify),
+     * which runs in O(n + m) time; a small @rhs is inserted element by
+     * element in O(m log(n + m)) time instead.
+     *
+     * Pending lazy updates of either queue are applied first; those of
+     * @rhs to a copy of it, since @rhs is left unchanged.
+     *
+     * Returns true if success.
+     * Returns false if max size would be exceeded
+     * (in which case, nothing is performed).
+     */
+    bool meld(const PriorityQueue& rhs);
+
+    /**
+     * Returns a newly constructed priority queue whose max size is the
+     * sum of both max sizes and that contains the elements of this
+     * priority queue melded with those of @rhs (see meld()). Pending
+     * lazy updates of both queues are applied to copies first.
+     */
+    PriorityQueue operator+(const PriorityQueue& rhs) const;
+
+    /**
+     * Changes the key of many elements at once. Each pair in @updates
+     * maps an existing key to its new key; pairs are applied in order,
+     * and a pair is skipped if its key is not found or its new key
+     * would be a duplicate.
+     *
+     * A small batch re-sifts each changed element in place, which runs
+     * in "constant time" + logarithmic time per pair. Once the batch is
+     * large enough that this would cost more than rebuilding, all keys
+     * are rewritten first and the heap is rebuilt bottom-up (heapify)
+     * in linear time.
+     *
+     * In lazy update mode, @updates is only appended to a buffer that
+     * is applied as one batch before the next operation that reads or
+     * modifies the heap (getMinKey(), deleteMin(), insert(), ...).
+     * Keys changed by a buffered update keep their old key until then.
+     *
+     * Returns the number of pairs applied, or, in lazy update mode,
+     * the number of pairs buffered.
+     */
+    unsigned updateKeys(const std::vector<std::pair<KeyType, KeyType>>& updates);
+
+    /**
+     * Switches lazy update mode on or off. Switching it off applies
+     * any pending updates.
+     */
+    void setLazyUpdates(bool lazy);
+    bool lazyUpdates() const {
+        return lazy_updates;
+    }
+
+    /**
+     * Applies the updates buffered in lazy update mode.
+     *
+     * Returns the number of pairs applied.
+     */
+    unsigned flushUpdates();
+
+    /**
+     * Writes the priority queue to @os in a binary format: a small
+     * header (format version, max size, number of elements, element
+     * sizes) followed by the underlying heap array as it is, which is
+     * already heap-ordered. The stream is written to directly, so a
+     * file stream never holds more than its own buffer in memory.
+     *
+     * If the key-value pairs are trivially copyable the array is
+     * written with a single write(); otherwise every key and value goes
+     * through writeBinary(). The format uses the byte order and type
+     * sizes of the machine, which load() checks.
+     *
+     * Throws std::runtime_error if lazy updates are pending; call
+     * flushUpdates() first.
+     */
+    void save(std::ostream& os) const;
+
+    /**
+     * Reads a priority queue written by save() from @is.
+     *
+     * No sifting is done: the heap array is read back in place and the
+     * hash table of positions is rebuilt in one linear pass, which also
+     * checks that the keys are unique and heap-ordered.
+     *
+     * Throws std::runtime_error if the header does not match this
+     * instantiation of PriorityQueue, the data is truncated, or the
+     * heap is not valid.
+     */
+    static PriorityQueue load(std::istream& is, const Compare& compare = Compare());
 
 private:
     // TODO: Your members here.
-    std::unique_ptr<KeyValuePair<ValueType>[]> binary_heap;
-    HashTable<unsigned> ht;
+    std::unique_ptr<KeyValuePair<ValueType, KeyType>[]> binary_heap;
+    HashTable<unsigned, KeyType> ht;
+    Compare compare;
     unsigned max_size;
     unsigned num_element;
+    std::vector<std::pair<KeyType, KeyType>> pending_updates;
+    bool lazy_updates;
 
     void swap(unsigned pos_1, unsigned pos_2);
     unsigned percolate(unsigned pos);
-    bool isPrime(unsigned table_size);
-    unsigned nextPrime(unsigned maxSize);
+    void siftDown(unsigned pos);
+    void heapify();
+    void requireNoPendingUpdates() const;
+    unsigned applyUpdates(const std::vector<std::pair<KeyType, KeyType>>& updates);
 };
 
 #include "priority_queue.inl"
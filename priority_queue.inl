@@ -1,37 +1,18 @@
-template <typename ValueType>
-bool PriorityQueue<ValueType>::isPrime(unsigned table_size) {
-    for(unsigned i = 2; i < std::sqrt(table_size); i++) {
-        if(table_size % i == 0) {
-            return false;
-        }
-    }
-    return true;
-}
-
-template <typename ValueType>
-unsigned PriorityQueue<ValueType>::nextPrime(unsigned maxSize) {
-    unsigned table_size = maxSize;
-    while(!isPrime(table_size)) {
-        ++table_size;
-    }
-    return table_size;
-}
-
-template <typename ValueType>
-void PriorityQueue<ValueType>::swap(unsigned pos_1, unsigned pos_2) {
-    KeyValuePair<ValueType> temp = binary_heap[pos_1];
+template <typename ValueType, typename KeyType, typename Compare>
+void PriorityQueue<ValueType, KeyType, Compare>::swap(unsigned pos_1, unsigned pos_2) {
+    KeyValuePair<ValueType, KeyType> temp = binary_heap[pos_1];
     binary_heap[pos_1] = binary_heap[pos_2];
     binary_heap[pos_2] = temp;
 }
 
-template <typename ValueType>
-unsigned PriorityQueue<ValueType>::percolate(unsigned pos) {
+template <typename ValueType, typename KeyType, typename Compare>
+unsigned PriorityQueue<ValueType, KeyType, Compare>::percolate(unsigned pos) {
     unsigned key_pos = pos;
 
-    while((key_pos/2 >= 1 && binary_heap[key_pos].key < binary_heap[key_pos/2].key) || 
-          (key_pos*2 <= num_element && binary_heap[key_pos].key > binary_heap[key_pos*2].key) ||
-          (key_pos*2+1 <= num_element && binary_heap[key_pos].key > binary_heap[key_pos*2+1].key)) {
-        if(binary_heap[key_pos].key < binary_heap[key_pos/2].key) {   // percolate up
+    while((key_pos/2 >= 1 && compare(binary_heap[key_pos].key, binary_heap[key_pos/2].key)) || 
+          (key_pos*2 <= num_element && compare(binary_heap[key_pos*2].key, binary_heap[key_pos].key)) ||
+          (key_pos*2+1 <= num_element && compare(binary_heap[key_pos*2+1].key, binary_heap[key_pos].key))) {
+        if(key_pos/2 >= 1 && compare(binary_heap[key_pos].key, binary_heap[key_pos/2].key)) {   // percolate up
             swap(key_pos, key_pos/2);
             ht.update(binary_heap[key_pos].key, key_pos);
             ht.update(binary_heap[key_pos/2].key, key_pos/2);
@@ -39,26 +20,27 @@ unsigned PriorityQueue<ValueType>::percolate(unsigned pos) {
         //  percolate down
         }else if(key_pos*2 <= num_element && 
                 key_pos*2+1 <= num_element && 
-                binary_heap[key_pos].key > binary_heap[key_pos*2].key && 
-                binary_heap[key_pos].key > binary_heap[key_pos*2+1].key) {  
+                compare(binary_heap[key_pos*2].key, binary_heap[key_pos].key) && 
+                compare(binary_heap[key_pos*2+1].key, binary_heap[key_pos].key)) {  
 
-            if(binary_heap[key_pos*2].key < binary_heap[key_pos*2+1].key) {
-                swap(key_pos, key_pos*2);
-                ht.update(binary_heap[key_pos].key, key_pos);
-                ht.update(binary_heap[key_pos*2].key, key_pos*2);
-                key_pos *= 2;
-            }else if(binary_heap[key_pos*2].key > binary_heap[key_pos*2+1].key){
+            // same choice as siftDown(), so that children that tie still move
+            if(compare(binary_heap[key_pos*2+1].key, binary_heap[key_pos*2].key)) {
                 swap(key_pos, key_pos*2+1);
                 ht.update(binary_heap[key_pos].key, key_pos);
                 ht.update(binary_heap[key_pos*2+1].key, key_pos*2+1);
                 key_pos = key_pos * 2 + 1;
+            }else {
+                swap(key_pos, key_pos*2);
+                ht.update(binary_heap[key_pos].key, key_pos);
+                ht.update(binary_heap[key_pos*2].key, key_pos*2);
+                key_pos *= 2;
             }
-        }else if(binary_heap[key_pos].key > binary_heap[key_pos*2].key) {
+        }else if(compare(binary_heap[key_pos*2].key, binary_heap[key_pos].key)) {
             swap(key_pos, key_pos*2);
             ht.update(binary_heap[key_pos].key, key_pos);
             ht.update(binary_heap[key_pos*2].key, key_pos*2);
             key_pos *= 2;
-        }else if(binary_heap[key_pos].key > binary_heap[key_pos*2+1].key) {
+        }else if(compare(binary_heap[key_pos*2+1].key, binary_heap[key_pos].key)) {
             swap(key_pos, key_pos*2+1);
             ht.update(binary_heap[key_pos].key, key_pos);
             ht.update(binary_heap[key_pos*2+1].key, key_pos*2 + 1);
@@ -68,9 +50,30 @@ unsigned PriorityQueue<ValueType>::percolate(unsigned pos) {
     return key_pos;
 }
 
-template <typename ValueType>
-bool PriorityQueue<ValueType>::insert(unsigned key, const ValueType& value) {
-    KeyValuePair<ValueType> pair = {key, value};
+template <typename ValueType, typename KeyType, typename Compare>
+void PriorityQueue<ValueType, KeyType, Compare>::siftDown(unsigned pos) {
+    KeyValuePair<ValueType, KeyType> moving = std::move(binary_heap[pos]);
+
+    while(pos*2 <= num_element) {
+        unsigned child = pos*2;
+        if(child+1 <= num_element && compare(binary_heap[child+1].key, binary_heap[child].key)) {
+            ++child;
+        }
+        if(!compare(binary_heap[child].key, moving.key)) {
+            break;
+        }
+        binary_heap[pos] = std::move(binary_heap[child]);
+        ht.update(binary_heap[pos].key, pos);
+        pos = child;
+    }
+    binary_heap[pos] = std::move(moving);
+    ht.update(binary_heap[pos].key, pos);
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+bool PriorityQueue<ValueType, KeyType, Compare>::insert(const KeyType& key, const ValueType& value) {
+    flushUpdates();
+    KeyValuePair<ValueType, KeyType> pair = {key, value};
     unsigned key_pos = 1;
     
     if(get(key) != nullptr || num_element + 1 > max_size) {
@@ -84,95 +87,411 @@ bool PriorityQueue<ValueType>::insert(unsigned key, const ValueType& value) {
     return true;
 }
 
-template <typename ValueType>
-const unsigned* PriorityQueue<ValueType>::getMinKey() const {
+template <typename ValueType, typename KeyType, typename Compare>
+const KeyType* PriorityQueue<ValueType, KeyType, Compare>::getMinKey() {
+    flushUpdates();
+    if(num_element == 0) {
+        return nullptr;
+    }
     return &(binary_heap[1].key);
 }
 
-template <typename ValueType>
-const ValueType* PriorityQueue<ValueType>::getMinValue() const {
+template <typename ValueType, typename KeyType, typename Compare>
+const KeyType* PriorityQueue<ValueType, KeyType, Compare>::getMinKey() const {
+    requireNoPendingUpdates();
+    if(num_element == 0) {
+        return nullptr;
+    }
+    return &(binary_heap[1].key);
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+const ValueType* PriorityQueue<ValueType, KeyType, Compare>::getMinValue() {
+    flushUpdates();
+    if(num_element == 0) {
+        return nullptr;
+    }
     return &(binary_heap[1].value);
 }
 
-template <typename ValueType>
-bool PriorityQueue<ValueType>::deleteMin() {
-    unsigned key_pos = 1;
+template <typename ValueType, typename KeyType, typename Compare>
+const ValueType* PriorityQueue<ValueType, KeyType, Compare>::getMinValue() const {
+    requireNoPendingUpdates();
+    if(num_element == 0) {
+        return nullptr;
+    }
+    return &(binary_heap[1].value);
+}
 
+template <typename ValueType, typename KeyType, typename Compare>
+bool PriorityQueue<ValueType, KeyType, Compare>::deleteMin() {
+    return extractMin().has_value();
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+std::optional<KeyValuePair<ValueType, KeyType>> PriorityQueue<ValueType, KeyType, Compare>::extractMin() {
+    flushUpdates();
     if(num_element == 0) {
-        return false;
+        return std::nullopt;
     }
-    ht.remove(binary_heap[1].key);
-    binary_heap[1] = binary_heap[num_element];
+    KeyValuePair<ValueType, KeyType> min = std::move(binary_heap[1]);
+    ht.remove(min.key);
     --num_element;
-    key_pos = percolate(1);
+    if(num_element > 0) {
+        binary_heap[1] = std::move(binary_heap[num_element+1]);
+        siftDown(1);
+    }
+    return min;
+}
 
-    return true;
+template <typename ValueType, typename KeyType, typename Compare>
+unsigned PriorityQueue<ValueType, KeyType, Compare>::popBatch(unsigned k, std::vector<KeyValuePair<ValueType, KeyType>>& out) {
+    flushUpdates();
+    if(k > num_element) {
+        k = num_element;
+    }
+    if(k == 0) {
+        return 0;
+    }
+
+    // select the k smallest by walking down from the root; a position is
+    // only a candidate once its parent has been taken
+    auto larger = [this](unsigned a, unsigned b) {
+        return compare(binary_heap[b].key, binary_heap[a].key);
+    };
+    std::vector<unsigned> frontier = {1};
+    std::vector<unsigned> holes;
+    holes.reserve(k);
+    out.reserve(out.size() + k);
+    while(holes.size() < k) {
+        std::pop_heap(frontier.begin(), frontier.end(), larger);
+        unsigned pos = frontier.back();
+        frontier.pop_back();
+        holes.push_back(pos);
+        out.push_back(std::move(binary_heap[pos]));
+        ht.remove(out.back().key);
+        for(unsigned child = pos*2; child <= pos*2+1 && child <= num_element; child++) {
+            frontier.push_back(child);
+            std::push_heap(frontier.begin(), frontier.end(), larger);
+        }
+    }
+
+    // refill holes inside the new size with the surviving tail elements
+    std::sort(holes.begin(), holes.end());
+    unsigned new_size = num_element - k;
+    auto tail_holes = std::upper_bound(holes.begin(), holes.end(), new_size);
+    auto skip = tail_holes;
+    auto fill = holes.begin();
+    for(unsigned pos = new_size+1; pos <= num_element && fill != tail_holes; pos++) {
+        if(skip != holes.end() && *skip == pos) {
+            ++skip;
+            continue;
+        }
+        binary_heap[*fill] = std::move(binary_heap[pos]);
+        ++fill;
+    }
+    num_element = new_size;
+
+    // every ancestor of a hole is a hole, so sifting them down from the
+    // deepest one up restores the heap as heapify would
+    while(fill != holes.begin()) {
+        --fill;
+        siftDown(*fill);
+    }
+    return k;
 }
 
-template <typename ValueType>
-ValueType* PriorityQueue<ValueType>::get(unsigned key) {
+template <typename ValueType, typename KeyType, typename Compare>
+std::optional<KeyValuePair<ValueType, KeyType>> PriorityQueue<ValueType, KeyType, Compare>::replaceMin(const KeyType& key, const ValueType& value) {
+    flushUpdates();
+    if(num_element == 0 || (ht.get(key) != nullptr && !(key == binary_heap[1].key))) {
+        return std::nullopt;
+    }
+    KeyValuePair<ValueType, KeyType> min = std::move(binary_heap[1]);
+    ht.remove(min.key);
+    binary_heap[1] = {key, value};
+    ht.insert(key, 1);
+    siftDown(1);
+    return min;
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+ValueType* PriorityQueue<ValueType, KeyType, Compare>::get(const KeyType& key) {
+    flushUpdates();
     if(ht.get(key) == nullptr) {
         return nullptr;
     }
     return &(binary_heap[*(ht.get(key))].value);
 }
 
-template <typename ValueType>
-const ValueType* PriorityQueue<ValueType>::get(unsigned key) const {
+template <typename ValueType, typename KeyType, typename Compare>
+const ValueType* PriorityQueue<ValueType, KeyType, Compare>::get(const KeyType& key) const {
+    requireNoPendingUpdates();
     if(ht.get(key) == nullptr) {
         return nullptr;
     }
     return &(binary_heap[*(ht.get(key))].value);
 }
 
-template <typename ValueType>
-bool PriorityQueue<ValueType>::decreaseKey(unsigned key, unsigned change) {
-    if(change == 0 || ht.get(key) == nullptr) {
+template <typename ValueType, typename KeyType, typename Compare>
+bool PriorityQueue<ValueType, KeyType, Compare>::changeKey(const KeyType& key, const KeyType& newKey) {
+    flushUpdates();
+    if(key == newKey || ht.get(key) == nullptr || ht.get(newKey) != nullptr) {
         return false;
     }
 
     unsigned pos = *(ht.get(key));
-    if(ht.get(binary_heap[pos].key - change) != nullptr) {
-        return false;
-    }
     ht.remove(key);
-    binary_heap[pos].key -= change;
+    binary_heap[pos].key = newKey;
     pos = percolate(pos);
     ht.insert(binary_heap[pos].key, pos);
 
     return true;
 }
 
-template <typename ValueType>
-bool PriorityQueue<ValueType>::increaseKey(unsigned key, unsigned change) {
-    if(change == 0 || ht.get(key) == nullptr) {
+template <typename ValueType, typename KeyType, typename Compare>
+bool PriorityQueue<ValueType, KeyType, Compare>::decreaseKey(const KeyType& key, const KeyType& change) {
+    if(change == KeyType()) {
         return false;
     }
+    return changeKey(key, key - change);
+}
 
-    unsigned pos = *(ht.get(key));
-    if(ht.get(binary_heap[pos].key + change) != nullptr) {
+template <typename ValueType, typename KeyType, typename Compare>
+bool PriorityQueue<ValueType, KeyType, Compare>::increaseKey(const KeyType& key, const KeyType& change) {
+    if(change == KeyType()) {
         return false;
     }
-    ht.remove(key);
-    binary_heap[pos].key += change;
-    pos = percolate(pos);
-    ht.insert(binary_heap[pos].key, pos);
-
-    return true;
+    return changeKey(key, key + change);
 }
 
-template <typename ValueType>
-bool PriorityQueue<ValueType>::remove(unsigned key) {
+template <typename ValueType, typename KeyType, typename Compare>
+bool PriorityQueue<ValueType, KeyType, Compare>::remove(const KeyType& key) {
+    flushUpdates();
     if(ht.get(key) == nullptr) {
         return false;
     }
 
     unsigned pos = *(ht.get(key));
     ht.remove(key);
-    binary_heap[pos] = binary_heap[num_element];
     --num_element;
-    pos = percolate(pos);
-    ht.update(key, pos);
+    if(pos <= num_element) {
+        binary_heap[pos] = std::move(binary_heap[num_element+1]);
+        pos = percolate(pos);
+        ht.update(binary_heap[pos].key, pos);
+    }
 
     return true;
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+void PriorityQueue<ValueType, KeyType, Compare>::requireNoPendingUpdates() const {
+    if(!pending_updates.empty()) {
+        throw std::runtime_error("Lazy updates pending; call flushUpdates() first");
+    }
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+void PriorityQueue<ValueType, KeyType, Compare>::heapify() {
+    for(unsigned pos = num_element / 2; pos >= 1; pos--) {
+        siftDown(pos);
+    }
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+bool PriorityQueue<ValueType, KeyType, Compare>::meld(const PriorityQueue& rhs) {
+    flushUpdates();
+    if(this == &rhs) {
+        return true;
+    }
+    if(!rhs.pending_updates.empty()) {   // meld what @rhs would hold after a flush
+        PriorityQueue flushed(rhs);
+        flushed.flushUpdates();
+        return meld(flushed);
+    }
+
+    unsigned num_new = 0;
+    for(unsigned i = 1; i <= rhs.num_element; i++) {
+        if(ht.get(rhs.binary_heap[i].key) == nullptr) {
+            ++num_new;
+        }
+    }
+    if(num_element + num_new > max_size) {
+        return false;
+    }
+
+    // heapify costs about n + m moves, one insert about log2(n + m)
+    unsigned log_size = 1;
+    while((1u << log_size) < num_element + num_new && log_size < 31) {
+        ++log_size;
+    }
+    if((unsigned long long)num_new * log_size < num_element + num_new) {
+        for(unsigned i = 1; i <= rhs.num_element; i++) {
+            insert(rhs.binary_heap[i].key, rhs.binary_heap[i].value);
+        }
+        return true;
+    }
+
+    for(unsigned i = 1; i <= rhs.num_element; i++) {
+        if(ht.get(rhs.binary_heap[i].key) == nullptr) {
+            ++num_element;
+            binary_heap[num_element] = rhs.binary_heap[i];
+            ht.insert(rhs.binary_heap[i].key, num_element);
+        }
+    }
+    heapify();
+    return true;
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+PriorityQueue<ValueType, KeyType, Compare> PriorityQueue<ValueType, KeyType, Compare>::operator+(const PriorityQueue& rhs) const {
+    if(!pending_updates.empty()) {
+        PriorityQueue flushed(*this);
+        flushed.flushUpdates();
+        return flushed + rhs;
+    }
+    PriorityQueue sum_queue(max_size + rhs.max_size, compare);
+
+    for(unsigned i = 1; i <= num_element; i++) {    // already heap-ordered
+        sum_queue.binary_heap[i] = binary_heap[i];
+        sum_queue.ht.insert(binary_heap[i].key, i);
+    }
+    sum_queue.num_element = num_element;
+    sum_queue.meld(rhs);
+    return sum_queue;
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+unsigned PriorityQueue<ValueType, KeyType, Compare>::applyUpdates(const std::vector<std::pair<KeyType, KeyType>>& updates) {
+    unsigned applied = 0;
+
+    // re-sifting costs about log2(n) moves per update, heapify about n
+    unsigned log_size = 1;
+    while((1u << log_size) < num_element && log_size < 31) {
+        ++log_size;
+    }
+    bool rebuild = (unsigned long long)updates.size() * log_size >= num_element;
+
+    for(unsigned i = 0; i < updates.size(); i++) {
+        const KeyType& key = updates[i].first;
+        const KeyType& new_key = updates[i].second;
+        const unsigned* found = ht.get(key);
+        if(found == nullptr || key == new_key || ht.get(new_key) != nullptr) {
+            continue;
+        }
+        unsigned pos = *found;
+        ht.remove(key);
+        binary_heap[pos].key = new_key;
+        if(!rebuild) {
+            pos = percolate(pos);
+        }
+        ht.insert(new_key, pos);
+        ++applied;
+    }
+    if(rebuild && applied > 0) {
+        heapify();
+    }
+    return applied;
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+unsigned PriorityQueue<ValueType, KeyType, Compare>::updateKeys(const std::vector<std::pair<KeyType, KeyType>>& updates) {
+    if(lazy_updates) {
+        pending_updates.insert(pending_updates.end(), updates.begin(), updates.end());
+        return updates.size();
+    }
+    flushUpdates();
+    return applyUpdates(updates);
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+void PriorityQueue<ValueType, KeyType, Compare>::setLazyUpdates(bool lazy) {
+    lazy_updates = lazy;
+    if(!lazy) {
+        flushUpdates();
+    }
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+unsigned PriorityQueue<ValueType, KeyType, Compare>::flushUpdates() {
+    if(pending_updates.empty()) {
+        return 0;
+    }
+    std::vector<std::pair<KeyType, KeyType>> updates;
+    updates.swap(pending_updates);
+    return applyUpdates(updates);
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+void PriorityQueue<ValueType, KeyType, Compare>::save(std::ostream& os) const {
+    requireNoPendingUpdates();
+    const bool raw = std::is_trivially_copyable<KeyValuePair<ValueType, KeyType>>::value;
+
+    writeBinary(os, PQ_CHECKPOINT_MAGIC);
+    writeBinary(os, PQ_CHECKPOINT_VERSION);
+    writeBinary(os, (unsigned)raw);
+    writeBinary(os, (unsigned)sizeof(KeyType));
+    writeBinary(os, (unsigned)sizeof(ValueType));
+    writeBinary(os, max_size);
+    writeBinary(os, num_element);
+
+    if(raw) {
+        os.write(reinterpret_cast<const char*>(&binary_heap[1]),
+                 (std::streamsize)num_element * sizeof(KeyValuePair<ValueType, KeyType>));
+    }else {
+        for(unsigned i = 1; i <= num_element; i++) {
+            writeBinary(os, binary_heap[i].key);
+            writeBinary(os, binary_heap[i].value);
+        }
+    }
+}
+
+template <typename ValueType, typename KeyType, typename Compare>
+PriorityQueue<ValueType, KeyType, Compare> PriorityQueue<ValueType, KeyType, Compare>::load(std::istream& is, const Compare& compare) {
+    const bool raw = std::is_trivially_copyable<KeyValuePair<ValueType, KeyType>>::value;
+    unsigned magic = 0, version = 0, raw_flag = 0, key_size = 0, value_size = 0;
+    unsigned maxSize = 0, numElements = 0;
+
+    if(!readBinary(is, magic) || !readBinary(is, version) || !readBinary(is, raw_flag) ||
+       !readBinary(is, key_size) || !readBinary(is, value_size) ||
+       !readBinary(is, maxSize) || !readBinary(is, numElements)) {
+        throw std::runtime_error("Checkpoint header is truncated");
+    }
+    if(magic != PQ_CHECKPOINT_MAGIC || version != PQ_CHECKPOINT_VERSION) {
+        throw std::runtime_error("Not a priority queue checkpoint of this version");
+    }
+    if(raw_flag != (unsigned)raw || key_size != sizeof(KeyType) || value_size != sizeof(ValueType)) {
+        throw std::runtime_error("Checkpoint was written for different key or value types");
+    }
+    if(numElements > maxSize) {
+        throw std::runtime_error("Checkpoint has more elements than its max size");
+    }
+
+    PriorityQueue loaded(maxSize, compare);
+    if(numElements > maxSize / 2) {   // size the index once instead of rehashing midway
+        loaded.ht = HashTable<unsigned, KeyType>(nextPrime(numElements * 2 + 1));
+    }
+    if(raw) {
+        if(!is.read(reinterpret_cast<char*>(&loaded.binary_heap[1]),
+                    (std::streamsize)numElements * sizeof(KeyValuePair<ValueType, KeyType>))) {
+            throw std::runtime_error("Checkpoint data is truncated");
+        }
+    }else {
+        for(unsigned i = 1; i <= numElements; i++) {
+            if(!readBinary(is, loaded.binary_heap[i].key) || !readBinary(is, loaded.binary_heap[i].value)) {
+                throw std::runtime_error("Checkpoint data is truncated");
+            }
+        }
+    }
+
+    for(unsigned i = 1; i <= numElements; i++) {
+        if(i > 1 && compare(loaded.binary_heap[i].key, loaded.binary_heap[i/2].key)) {
+            throw std::runtime_error("Checkpoint heap is not heap-ordered");
+        }
+        if(!loaded.ht.insert(loaded.binary_heap[i].key, i)) {
+            throw std::runtime_error("Checkpoint heap has duplicate keys");
+        }
+    }
+    loaded.num_element = numElements;
+    return loaded;
 }
\ No newline at end of file
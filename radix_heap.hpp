@@ -0,0 +1,176 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <cassert>
+#include "hash_table.hpp"
+#include "priority_queue.hpp"
+
+/**
+ * Implementation of a radix heap that supports the same
+ * extended API as PriorityQueue, for the common case where the
+ * extracted keys never decrease (Dijkstra, discrete-event
+ * simulation with non-decreasing timestamps, ...).
+ *
+ * Elements are kept in 33 buckets relative to the last key
+ * removed by deleteMin() (call it "last"): bucket 0 holds the
+ * key equal to last, and bucket b > 0 holds the keys whose
+ * highest bit that differs from last is bit b-1. When bucket 0
+ * runs dry, deleteMin() takes the lowest non-empty bucket, makes
+ * its minimum the new last, and redistributes the bucket; every
+ * element lands in a strictly lower bucket, so each element is
+ * moved at most 32 times over its lifetime and the operations
+ * below run in amortized O(log C) time, C being the key range.
+ * Buckets are plain arrays, so redistribution is sequential.
+ *
+ * Monotonicity precondition: no key may be inserted, or
+ * decreased to, a value smaller than last. This is checked by
+ * assert() in debug builds; violating it with NDEBUG defined has
+ * an undefined effect.
+ *
+ * As with PriorityQueue, the hash table maps each key to its
+ * location (bucket and index) so that the keyed operations run
+ * in "constant time".
+ */
+
+struct BucketSlot{
+    unsigned bucket;
+    unsigned index;
+};
+
+template <typename ValueType>
+class RadixHeap
+{
+public:
+    /**
+     * Creates a radix heap that can have at most @maxSize elements.
+     *
+     * Throws std::runtime_error if @maxSize is 0.
+     */
+    explicit RadixHeap(unsigned maxSize) : ht(HashTable<BucketSlot>(nextPrime(maxSize))) {
+        if(maxSize == 0) {
+            throw std::runtime_error("Max Size can't be zero");
+        }
+        max_size = maxSize;
+        num_element = 0;
+        last = 0;
+        min_key = 0;
+        min_valid = false;
+    }
+
+    /**
+     * Both of these must run in constant time.
+     */
+    unsigned numElements() const {
+        return num_element;
+    }
+    unsigned maxSize() const {
+        return max_size;
+    }
+
+    /**
+     * Inserts a key-value pair mapping @key to @value.
+     *
+     * Returns true if success.
+     * In this case, must run in "constant time".
+     *
+     * Returns false if @key is already in the radix heap
+     * or if max size would be exceeded.
+     * (In either of these cases, the insertion is not performed.)
+     *
+     * @key must not be smaller than the last key removed by deleteMin().
+     */
+    bool insert(unsigned key, const ValueType& value);
+
+    /**
+     * Returns key/value of the smallest element or null pointer if empty.
+     *
+     * The smallest element is cached; after it has been removed the
+     * next call scans the lowest non-empty bucket, which the following
+     * deleteMin() then redistributes without scanning it again.
+     *
+     * The pointer may be invalidated if the radix heap is modified.
+     */
+    const unsigned* getMinKey() const;
+    const ValueType* getMinValue() const;
+
+    /**
+     * Removes the smallest element.
+     *
+     * This function must run in amortized O(log C) time.
+     *
+     * Returns true if success.
+     * Returns false if radix heap is empty, i.e. nothing to delete.
+     */
+    bool deleteMin();
+
+    /**
+     * Removes the smallest element and returns it, with its value
+     * moved out rather than copied.
+     *
+     * Returns std::nullopt if radix heap is empty.
+     */
+    std::optional<KeyValuePair<ValueType>> extractMin();
+
+    /**
+     * Returns address of the value that @key is mapped to.
+     *
+     * These functions must run in "constant time".
+     *
+     * Returns null pointer if @key is not in the radix heap.
+     */
+    ValueType* get(unsigned key);
+    const ValueType* get(unsigned key) const;
+
+    /**
+     * Subtracts/adds @change from/to the key of the element that
+     * has key @key.
+     *
+     * These functions must run in "constant time".
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @key not found.
+     * - If the change would lead to a duplicate key.
+     *
+     * decreaseKey() must not go below the last key removed by
+     * deleteMin(). Neither function does anything about
+     * overflow/underflow.
+     */
+    bool decreaseKey(unsigned key, unsigned change);
+    bool increaseKey(unsigned key, unsigned change);
+
+    /**
+     * Removes element that has key @key.
+     *
+     * This function must run in "constant time".
+     *
+     * Returns true if success.
+     * Returns false if @key not found.
+     */
+    bool remove(unsigned key);
+
+private:
+    static const unsigned NUM_BUCKETS = 33;
+
+    std::vector<KeyValuePair<ValueType>> buckets[NUM_BUCKETS];
+    HashTable<BucketSlot> ht;
+    unsigned max_size;
+    unsigned num_element;
+    unsigned last;
+    mutable unsigned min_key;
+    mutable bool min_valid;
+
+    unsigned bucketOf(unsigned key) const;
+    unsigned lowestBucket() const;
+    BucketSlot place(KeyValuePair<ValueType>&& pair);
+    KeyValuePair<ValueType> unplace(BucketSlot slot);
+    bool changeKey(unsigned key, unsigned newKey);
+};
+
+#include "radix_heap.inl"
+#endif  // RADIX_HEAP_HPP
@@ -0,0 +1,190 @@
+template <typename ValueType>
+unsigned RadixHeap<ValueType>::bucketOf(unsigned key) const {
+    unsigned diff = key ^ last;
+    if(diff == 0) {
+        return 0;
+    }
+#if defined(__GNUC__)
+    return 32 - __builtin_clz(diff);
+#else
+    unsigned bucket = 0;
+    while(diff != 0) {
+        diff >>= 1;
+        ++bucket;
+    }
+    return bucket;
+#endif
+}
+
+template <typename ValueType>
+unsigned RadixHeap<ValueType>::lowestBucket() const {
+    unsigned bucket = 0;
+    while(buckets[bucket].empty()) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+template <typename ValueType>
+BucketSlot RadixHeap<ValueType>::place(KeyValuePair<ValueType>&& pair) {
+    unsigned bucket = bucketOf(pair.key);
+    buckets[bucket].push_back(std::move(pair));
+    return {bucket, (unsigned)buckets[bucket].size() - 1};
+}
+
+template <typename ValueType>
+KeyValuePair<ValueType> RadixHeap<ValueType>::unplace(BucketSlot slot) {
+    std::vector<KeyValuePair<ValueType>>& bucket = buckets[slot.bucket];
+    KeyValuePair<ValueType> pair = std::move(bucket[slot.index]);
+    if(slot.index + 1 != bucket.size()) {
+        bucket[slot.index] = std::move(bucket.back());
+        ht.update(bucket[slot.index].key, slot);
+    }
+    bucket.pop_back();
+    return pair;
+}
+
+template <typename ValueType>
+bool RadixHeap<ValueType>::insert(unsigned key, const ValueType& value) {
+    if(ht.get(key) != nullptr || num_element + 1 > max_size) {
+        return false;
+    }
+    assert(key >= last && "radix heap keys must not go below the last deleted minimum");
+
+    ht.insert(key, place({key, value}));
+    ++num_element;
+    if(num_element == 1 || (min_valid && key < min_key)) {
+        min_key = key;
+        min_valid = true;
+    }
+    return true;
+}
+
+template <typename ValueType>
+const unsigned* RadixHeap<ValueType>::getMinKey() const {
+    if(num_element == 0) {
+        return nullptr;
+    }
+    if(!min_valid) {
+        const std::vector<KeyValuePair<ValueType>>& bucket = buckets[lowestBucket()];
+        min_key = bucket[0].key;
+        for(unsigned i = 1; i < bucket.size(); i++) {
+            if(bucket[i].key < min_key) {
+                min_key = bucket[i].key;
+            }
+        }
+        min_valid = true;
+    }
+    BucketSlot slot = *(ht.get(min_key));
+    return &(buckets[slot.bucket][slot.index].key);
+}
+
+template <typename ValueType>
+const ValueType* RadixHeap<ValueType>::getMinValue() const {
+    if(num_element == 0) {
+        return nullptr;
+    }
+    BucketSlot slot = *(ht.get(*getMinKey()));
+    return &(buckets[slot.bucket][slot.index].value);
+}
+
+template <typename ValueType>
+bool RadixHeap<ValueType>::deleteMin() {
+    return extractMin().has_value();
+}
+
+template <typename ValueType>
+std::optional<KeyValuePair<ValueType>> RadixHeap<ValueType>::extractMin() {
+    if(num_element == 0) {
+        return std::nullopt;
+    }
+
+    unsigned lowest = lowestBucket();
+    if(lowest != 0) {
+        last = *getMinKey();
+        std::vector<KeyValuePair<ValueType>> old = std::move(buckets[lowest]);
+        buckets[lowest].clear();
+        for(unsigned i = 0; i < old.size(); i++) {
+            unsigned key = old[i].key;
+            ht.update(key, place(std::move(old[i])));
+        }
+    }
+
+    KeyValuePair<ValueType> min = std::move(buckets[0].back());
+    buckets[0].pop_back();
+    ht.remove(min.key);
+    --num_element;
+    min_valid = false;
+    return min;
+}
+
+template <typename ValueType>
+ValueType* RadixHeap<ValueType>::get(unsigned key) {
+    BucketSlot* slot = ht.get(key);
+    if(slot == nullptr) {
+        return nullptr;
+    }
+    return &(buckets[slot->bucket][slot->index].value);
+}
+
+template <typename ValueType>
+const ValueType* RadixHeap<ValueType>::get(unsigned key) const {
+    const BucketSlot* slot = ht.get(key);
+    if(slot == nullptr) {
+        return nullptr;
+    }
+    return &(buckets[slot->bucket][slot->index].value);
+}
+
+template <typename ValueType>
+bool RadixHeap<ValueType>::changeKey(unsigned key, unsigned newKey) {
+    if(ht.get(key) == nullptr || ht.get(newKey) != nullptr) {
+        return false;
+    }
+    assert(newKey >= last && "radix heap keys must not go below the last deleted minimum");
+
+    KeyValuePair<ValueType> pair = unplace(*(ht.get(key)));
+    ht.remove(key);
+    pair.key = newKey;
+    ht.insert(newKey, place(std::move(pair)));
+
+    if(min_valid) {
+        if(newKey < min_key) {
+            min_key = newKey;
+        }else if(key == min_key) {
+            min_valid = false;
+        }
+    }
+    return true;
+}
+
+template <typename ValueType>
+bool RadixHeap<ValueType>::decreaseKey(unsigned key, unsigned change) {
+    if(change == 0) {
+        return false;
+    }
+    return changeKey(key, key - change);
+}
+
+template <typename ValueType>
+bool RadixHeap<ValueType>::increaseKey(unsigned key, unsigned change) {
+    if(change == 0) {
+        return false;
+    }
+    return changeKey(key, key + change);
+}
+
+template <typename ValueType>
+bool RadixHeap<ValueType>::remove(unsigned key) {
+    if(ht.get(key) == nullptr) {
+        return false;
+    }
+
+    unplace(*(ht.get(key)));
+    ht.remove(key);
+    --num_element;
+    if(min_valid && key == min_key) {
+        min_valid = false;
+    }
+    return true;
+}